@@ -11,6 +11,7 @@
 
 #include <limits.h>
 #include <DataTransmitter.h>
+#include <GPSDatasets.h>
 #include <DS18B20.h>
 #include <SoftwareSerial.h>
 #include <MoonSun.h>
@@ -43,52 +44,25 @@ const uint8_t RESOLUTION = 12; // 12 bit resolution == 0.0625°C
 
 // variables and constants used by the transmitter
 
-/* an array to hold the data to be transmitted
-for the dataset with ID 0 it contains 25 Byte:
-
-    GPS latitude in degree / uint8_t
-    GPS latitude in minutes / uint8_t
-    GPS latitude in seconds / uint8_t
-    GPS latitude orientation ('N', 'n', 'S', 's') / uint8_t
-    
-    GPS longitude in degree / uint8_t
-    GPS longitude in minutes / uint8_t
-    GPS longitude in seconds / uint8_t
-    GPS longitude orientation ('N', 'n', 'S', 's') / uint8_t
-    
-    GPS altitude in meter / uint16_t
-    
-    GPS speed over ground in km/h / uint8_t
-    
-    GPS number of satellites used / uint8_t
-
-    6-character Maidenhead locator / char[7] (7 Byte)
-    
-    outside temperature * 16 / int16_t
-    
-    the current UTC / time_t (4 Byte)
-
-for the dataset with ID 1 it contains 35 Byte:
-    GPS speed over ground in km/h / uint8_t
-
-    the Moon's and Sun's rise and set time / time_t[4] (Sunrise, Sunset, Moonrise, Moonset) / (16 Byte)
-
-    the timestamp for which the following data was calculated / time_t (4 Byte)
-    the Sun's azimuth in degree*100 (North = 0, East = 90, South = 180, West = 270) / int32_t
-    the Sun's altitude in degree*100 / int16_t
-    the Moon's azimuth in degree*100 (North = 0, East = 90, South = 180, West = 270) / int32_t
-    the Moon's altitude in degree*100 / int16_t
-    the Moon's phase in %*100 (positive for increasing phase) / int16_t
+/* the data to be transmitted; the layouts of the dataset with ID 0 (25 Byte: position, altitude, speed, locator,
+outside temperature and time) and the one with ID 1 (35 Byte: speed, Sun's and Moon's rise and set times, positions
+and the Moon's phase) are defined in the library "GPSDatasets"; only one of them is transmitted at a time, straight
+from this union
 */
-
-uint8_t data[35];
+union {
+  gps_dataset gps;
+  astro_dataset astro;
+} tx;
 
 // defines the dataset which is to be transmitted next
 uint8_t current_dataset = 1;
 
 const uint8_t TRANSMITTER_PIN = 12;
-const uint8_t BYTE_RATE = 30;
-const uint8_t LOOKUP_TABLE_START = 0;
+const uint8_t BYTE_RATE = 30; // 4...255 (the receivers detect the rate automatically)
+// 1 -> the datasets are transmitted with forward error correction (twice as long, but up to 1 bit error per
+// codeword, resp. bursts of up to 8 bit errors get corrected); the receivers have to accept them (WSPR beacon:
+// "GPS_FEC")
+const uint8_t USE_FEC = 0;
 
 // $GPZDA,184020.00,31,07,2017,00,00*68
 // $GPGGA,184212.00,5104.21487,N,01339.75269,E,1,09,0.94,122.8,M,43.7,M,,*52
@@ -401,16 +375,6 @@ initializes the GPS
   gpsSerial.println(F("$PUBX,40,ZDA,0,0,0,0,0,0*44"));
   delay(100);
 
-/*
-initializes the CRC8 library
-
-Parameter:
- - the EEPROM start address to store the 256 byte CRC lookup table
-
- returns the next free address in EEPROM
-*/
-  CRC.init(LOOKUP_TABLE_START);
-
 /*
 initializes the DataTransmitter library
 
@@ -438,7 +402,7 @@ void loop() {
 // trigger "transmit data" execution (runs every 19s)
   if(transmit_data_loop_counter == TRANSMIT_DATA_LOOPS) {
     
-    uint8_t base, pos; // used by the parsing process
+    uint8_t base; // used by the parsing process
     
     if(current_dataset) {
       
@@ -471,37 +435,31 @@ void loop() {
 
         sog = getSpeedOverGround();
 
+// Create a dataset (pointer to data, id)
+        dset_t dataset = DT.createDataset(&tx.gps, GPS_DATASET_ID | (USE_FEC ? FEC_FLAG : 0));
+
+// transfer data into the dataset (part 1)
+        tx.gps.lat_deg = lat_deg;
+        tx.gps.lat_min = lat_min;
+        tx.gps.lat_sec = lat_sec;
+        tx.gps.lat_o = lat_o;
+        tx.gps.long_deg = long_deg;
+        tx.gps.long_min = long_min;
+        tx.gps.long_sec = long_sec;
+        tx.gps.long_o = long_o;
+        tx.gps.alt = alt;
+        tx.gps.sog = sog;
+        tx.gps.sat = sat;
+
 // convert coordinates to 6-character Maidenhead-locator
-        char locator[7];
-        LatLongToLocator(locator, lat_deg, lat_min, lat_sec, lat_o, long_deg, long_min, long_sec, long_o);
+        LatLongToLocator(tx.gps.locator, lat_deg, lat_min, lat_sec, lat_o, long_deg, long_min, long_sec, long_o);
 
 // attempt reading temp-sensor (temp = 0x8000==-32768==0b1000 0000 0000 0000 in case of error)
-        int16_t temp = 0x8000;
+        tx.gps.temp = 0x8000;
         if(TS.convertTemp(1)) {
-          temp = TS.getTemp();
+          tx.gps.temp = TS.getTemp();
         }
 
-// Create a dataset (pointer to data, id, size)
-        dset_t dataset = DT.createDataset(data, 0, 25);
-
-// transfer data into array (part 1)
-        pos = 0;
-        pos = DT.dataTransfer(&lat_deg, 1, dataset, pos, 1);
-        pos = DT.dataTransfer(&lat_min, 1, dataset, pos, 1);
-        pos = DT.dataTransfer(&lat_sec, 1, dataset, pos, 1);
-        pos = DT.dataTransfer(&lat_o, 1, dataset, pos, 1);
-        pos = DT.dataTransfer(&long_deg, 1, dataset, pos, 1);
-        pos = DT.dataTransfer(&long_min, 1, dataset, pos, 1);
-        pos = DT.dataTransfer(&long_sec, 1, dataset, pos, 1);
-        pos = DT.dataTransfer(&long_o, 1, dataset, pos, 1);
-        pos = DT.dataTransfer(&alt, 2, dataset, pos, 1);
-        pos = DT.dataTransfer(&sog, 1, dataset, pos, 1);
-        pos = DT.dataTransfer(&sat, 1, dataset, pos, 1);
-
-        pos = DT.dataTransfer(locator, 7, dataset, pos, 1);
-
-        pos = DT.dataTransfer(&temp, 2, dataset, pos, 1);
-
 // poll ZDA dataset
         clearInputBuffer();
         gpsSerial.println(F("$EIGPQ,ZDA*39"));
@@ -524,8 +482,8 @@ void loop() {
           setTime(h,m,s,d,mt,y);
           t = now();
 
-// transfer data into array (part 2)
-          pos = DT.dataTransfer(&t, 4, dataset, pos, 1);
+// transfer data into the dataset (part 2)
+          tx.gps.utc = t;
           
           DT.transmitData(dataset); // latency to actual system time is about 9ms, mainly caused by serial communication with GPS
           flashLED(1, 250); // flashing 1x indicates transmission of dataset 0
@@ -543,12 +501,11 @@ void loop() {
 // poll VTG-data
       sog = getSpeedOverGround();
 
-// Create a dataset (pointer to data, id, size)
-      dset_t dataset = DT.createDataset(data, 1, 35);
+// Create a dataset (pointer to data, id)
+      dset_t dataset = DT.createDataset(&tx.astro, ASTRO_DATASET_ID | (USE_FEC ? FEC_FLAG : 0));
 
-// transfer data into array (part 1)
-      pos = 0;
-      pos = DT.dataTransfer(&sog, 1, dataset, pos, 1);
+// transfer data into the dataset (part 1)
+      tx.astro.sog = sog;
 
 // Calculate Sun's & Moon's rise/set times based on the current coordinates
       time_t tRS[2]; // rise and set times
@@ -576,33 +533,28 @@ void loop() {
         }
         while(is_obsolete==1);
 
-// transfer data into array (part 2)
-        pos = DT.dataTransfer(tRS, 8, dataset, pos, 1);
+// transfer data into the dataset (part 2)
+        tx.astro.rise_set[i] = tRS[0];
+        tx.astro.rise_set[i+1] = tRS[1];
       }
 
 // Calculate Sun's and Moon's current position      
       dset pos_data = MS.Position(t, lat_deg, lat_min, lat_sec, lat_o, long_deg, long_min, long_sec, long_o);
       
+// transfer data into the dataset (part 3)
+      tx.astro.timestamp = t;
 // calculate the Sun's azimuth in degree*100 (North = 0, East = 90, South = 180, West = 270)
-      int32_t azs  = MS.radToDegree(pos_data.x[0]);
+      tx.astro.sun_az = MS.radToDegree(pos_data.x[0]);
 // calculate the Sun's altitude in degree*100
-      int16_t alts = MS.radToDegree(pos_data.x[1]);
+      tx.astro.sun_alt = MS.radToDegree(pos_data.x[1]);
 
 // calculate the Moon's azimuth in degree*100
-      int32_t azm  = MS.radToDegree(pos_data.x[2]);
+      tx.astro.moon_az = MS.radToDegree(pos_data.x[2]);
 // calculate the Moon's altitude in degree*100
-      int16_t altm_topoc = MS.radToDegree(pos_data.x[3]);
+      tx.astro.moon_alt = MS.radToDegree(pos_data.x[3]);
 
 // calculate the Moon's phase in %*100 (positive for increasing phase)
-      int16_t phasem = 100.0*pos_data.x[4];
-      
-// transfer data into array (part 3)
-      pos = DT.dataTransfer(&t, 4, dataset, pos, 1);
-      pos = DT.dataTransfer(&azs, 4, dataset, pos, 1);
-      pos = DT.dataTransfer(&alts, 2, dataset, pos, 1);
-      pos = DT.dataTransfer(&azm, 4, dataset, pos, 1);
-      pos = DT.dataTransfer(&altm_topoc, 2, dataset, pos, 1);
-      DT.dataTransfer(&phasem, 2, dataset, pos, 1);
+      tx.astro.moon_phase = 100.0*pos_data.x[4];
   
 // transmit
       DT.transmitData(dataset);
@@ -10,10 +10,10 @@
 */
 
 #include <DataReceiver.h>
+#include <GPSDatasets.h>
 #include <DS18B20.h>
 #include <TimeLib.h>
 #include <limits.h>
-#include <util/atomic.h>
 
 //##############################################################################################################
 //##############################################################################################################
@@ -37,8 +37,7 @@ uint32_t check_data_available_loop_counter = 0;
 
 // variables and constants used by the receiver
 
-const uint8_t BYTE_RATE = 30;
-const uint8_t LOOKUP_TABLE_START = 0; // EEPROM lookup table used by CRC-library
+const uint8_t BYTE_RATE = DR_AUTO_BAUD; // the receiver locks to the byte rate set at the GPS-module
 const uint8_t RECEIVER_PIN = 2; // Arduino Nano has interrupt 1 at port D2
 /*
   array of "dset_r" (defined in the DataReceiver library)
@@ -48,43 +47,39 @@ const uint8_t RECEIVER_PIN = 2; // Arduino Nano has interrupt 1 at port D2
     uint8_t ID; // the ID of the dataset
     uint8_t SIZE; // number of elements
     f_ptr FUNCTION; // a function to be called for data-processing
+    uint16_t delivered; // the number of datasets with this ID handed over valid
   }
 */
-dset_r dataset[2];
+dset_r dataset[4];
+// the receive buffer (2 slots for the biggest dataset, received as codewords)
+uint8_t rx_buffer[drBufferSize(2, drFrameSize(FEC_FLAG, GPS_DATASETS_MAX_SIZE))];
 
 //##############################################################################################################
 //##############################################################################################################
 
 // dataset 0 is available -> process data
-// keep processing short; no new data will be received while this one is busy!!!
+// keep processing short; meanwhile further datasets are received into the other slots only
 void processDataset_0() {
   Serial.println(F("Received dataset with ID 0:\n"));
     
-  uint8_t *data = DR.getDataArray();
+  const gps_dataset *gps = DR.getDataset<gps_dataset>();
     
-  Serial.print(F("Latitude: "));Serial.print(*data);Serial.print(F(" deg  "));Serial.print(*(data+1));
-  Serial.print(F(" min  "));Serial.print(*(data+2));Serial.print(F(" sec  "));Serial.println(char(*(data+3)));
-  Serial.print(F("Longitude: "));Serial.print(*(data+4));Serial.print(F(" deg  "));Serial.print(*(data+5));
-  Serial.print(F(" min  "));Serial.print(*(data+6));Serial.print(F(" sec  "));Serial.println(char(*(data+7)));
+  Serial.print(F("Latitude: "));Serial.print(gps->lat_deg);Serial.print(F(" deg  "));Serial.print(gps->lat_min);
+  Serial.print(F(" min  "));Serial.print(gps->lat_sec);Serial.print(F(" sec  "));Serial.println(gps->lat_o);
+  Serial.print(F("Longitude: "));Serial.print(gps->long_deg);Serial.print(F(" deg  "));Serial.print(gps->long_min);
+  Serial.print(F(" min  "));Serial.print(gps->long_sec);Serial.print(F(" sec  "));Serial.println(gps->long_o);
 
-  uint16_t alt;
-  DR.dataTransfer(&alt, 2, 8, 0);
-  Serial.print(F("Altitude: "));Serial.print(alt);Serial.println(F(" meter"));
+  Serial.print(F("Altitude: "));Serial.print(gps->alt);Serial.println(F(" meter"));
 
-  Serial.print(F("Speed over ground: "));Serial.print(*(data+10));Serial.println(F(" km/h"));
+  Serial.print(F("Speed over ground: "));Serial.print(gps->sog);Serial.println(F(" km/h"));
 
-  Serial.print(F("Number of satellites in use: "));Serial.println(*(data+11));
+  Serial.print(F("Number of satellites in use: "));Serial.println(gps->sat);
 
-  char loc[7];
-  DR.dataTransfer(loc, 7, 12, 0);
-  Serial.print(F("Maidenhead locator: "));Serial.println(loc);
+  Serial.print(F("Maidenhead locator: "));Serial.println(gps->locator);
 
-  int16_t temp;
-  DR.dataTransfer(&temp, 2, 19, 0);
-  Serial.print(F("Temperature: "));Serial.print(((float) temp)/16.0, 1);Serial.println(F(" °C"));
+  Serial.print(F("Temperature: "));Serial.print(((float) gps->temp)/16.0, 1);Serial.println(F(" °C"));
 
-  time_t utc;
-  DR.dataTransfer(&utc, 4, 21, 0);
+  time_t utc = gps->utc;
   uint16_t d_s;
   // calculate time [ms] since dataset was received
   int32_t d_ms = millis() - DR.getTimestamp();
@@ -105,16 +100,18 @@ void processDataset_0() {
 //##############################################################################################################
 
 // dataset 1 is available -> process data
-// keep processing short; no new data will be received while this one is busy!!!
+// keep processing short; meanwhile further datasets are received into the other slots only
 void processDataset_1() {
   Serial.println(F("Received dataset with ID 1:\n"));
     
-  uint8_t sog;
-  DR.dataTransfer(&sog, 1, 0, 0);
-  Serial.print(F("Speed over ground: "));Serial.print(sog);Serial.println(F(" km/h\n"));
+  const astro_dataset *astro = DR.getDataset<astro_dataset>();
+
+  Serial.print(F("Speed over ground: "));Serial.print(astro->sog);Serial.println(F(" km/h\n"));
 
   time_t rs[4];
-  DR.dataTransfer(rs, 16, 1, 0);
+  for(uint8_t i=0; i<4; ++i) {
+    rs[i] = astro->rise_set[i];
+  }
   Serial.print(F("Sunrise: "));Serial.print(month(rs[0]));Serial.print(F("/"));Serial.print(day(rs[0]));
   Serial.print(F("   "));Serial.print(hour(rs[0]));Serial.print(F(":"));Serial.println(minute(rs[0]));
   Serial.print(F("Sunset: "));Serial.print(month(rs[1]));Serial.print(F("/"));Serial.print(day(rs[1]));
@@ -125,28 +122,20 @@ void processDataset_1() {
   Serial.print(F("   "));Serial.print(hour(rs[3]));Serial.print(F(":"));Serial.println(minute(rs[3]));
   Serial.println();
 
-  time_t pos_ts;
-  DR.dataTransfer(&pos_ts, 4, 17, 0);
+  time_t pos_ts = astro->timestamp;
   Serial.print(F("Sun's position at   "));Serial.print(month(pos_ts));Serial.print(F("/"));Serial.print(day(pos_ts));
   Serial.print(F("   "));Serial.print(hour(pos_ts));Serial.print(F(":"));Serial.print(minute(pos_ts));
   Serial.print(F(":"));Serial.println(second(pos_ts));
-  int32_t az;
-  int16_t al;
-  DR.dataTransfer(&az, 4, 21, 0);
-  DR.dataTransfer(&al, 2, 25, 0);
-  Serial.print(F("Azimuth in degree (N=0, E=90, S=180, W=270): "));Serial.println(((float) az)/100.0, 1);
-  Serial.print(F("Altitude in degree: "));Serial.println(((float) al)/100.0, 1);
+  Serial.print(F("Azimuth in degree (N=0, E=90, S=180, W=270): "));Serial.println(((float) astro->sun_az)/100.0, 1);
+  Serial.print(F("Altitude in degree: "));Serial.println(((float) astro->sun_alt)/100.0, 1);
   Serial.println();
 
   Serial.print(F("Moon's position at   "));Serial.print(month(pos_ts));Serial.print(F("/"));Serial.print(day(pos_ts));
   Serial.print(F("   "));Serial.print(hour(pos_ts));Serial.print(F(":"));Serial.print(minute(pos_ts));
   Serial.print(F(":"));Serial.println(second(pos_ts));
-  DR.dataTransfer(&az, 4, 27, 0);
-  DR.dataTransfer(&al, 2, 31, 0);
-  Serial.print(F("Azimuth in degree (N=0, E=90, S=180, W=270): "));Serial.println(((float) az)/100.0, 1);
-  Serial.print(F("Altitude in degree: "));Serial.println(((float) al)/100.0, 1);
-  int16_t phase;
-  DR.dataTransfer(&phase, 2, 33, 0);
+  Serial.print(F("Azimuth in degree (N=0, E=90, S=180, W=270): "));Serial.println(((float) astro->moon_az)/100.0, 1);
+  Serial.print(F("Altitude in degree: "));Serial.println(((float) astro->moon_alt)/100.0, 1);
+  int16_t phase = astro->moon_phase;
   Serial.print(F("The Moon's phase is "));Serial.print(((float) abs(phase))/100.0, 1);Serial.print(F("% "));
   if(phase > 0) {
     Serial.println(F("increasing."));
@@ -163,30 +152,24 @@ void processDataset_1() {
 
 void setup() {
 
-/*
-initializes the CRC library
-
-Parameter:
- - the EEPROM start address to store the 256 byte CRC lookup table
-
- returns the next free address in EEPROM
-*/
-  CRC.init(LOOKUP_TABLE_START);
-
 // create datasets
-  dataset[0] = DR.createDataset(0, 25, processDataset_0);
-  dataset[1] = DR.createDataset(1, 35, processDataset_1);
+  dataset[0] = DR.createDataset<gps_dataset>(GPS_DATASET_ID, processDataset_0);
+  dataset[1] = DR.createDataset<astro_dataset>(ASTRO_DATASET_ID, processDataset_1);
+// the same datasets sent with forward error correction
+  dataset[2] = DR.createDataset<gps_dataset>(GPS_DATASET_ID | FEC_FLAG, processDataset_0);
+  dataset[3] = DR.createDataset<astro_dataset>(ASTRO_DATASET_ID | FEC_FLAG, processDataset_1);
 
 /*
 initializes the DataReceiver
 
 Parameter DataReceiver (f.l.t.r.):
-"BYTE_RATE" -> the data transfer rate set at the transmitter in Byte/s
+"BYTE_RATE" -> the data transfer rate set at the transmitter in Byte/s (DR_AUTO_BAUD -> detected automatically)
 "RECEIVER_PIN" -> the digital, interrupt-capable pin the receiver is connected to
 "d_set" -> array of "dset", holding all dataset-relevant information
 "DATASET_COUNT" -> the number of datasets (size of DATASET)
+"rx_buffer" -> the receive buffer (statically allocated) and its size
 */
-  if(!DR.init(BYTE_RATE, RECEIVER_PIN, dataset, 2)) {
+  if(!DR.init(BYTE_RATE, RECEIVER_PIN, dataset, 4, rx_buffer, sizeof(rx_buffer))) {
     pinMode(13, OUTPUT); // onboard LED will start flashing if receiver could not be initialized
     while(true) {
       digitalWrite(13, !digitalRead(13));
@@ -216,13 +199,8 @@ void loop() {
 // trigger "check data available" execution (runs every 4s)
   if(check_data_available_loop_counter == CHECK_DATA_AVAILABLE_LOOPS) {
 
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { // this makes sure the following block of code will not get interrupted 
-      if(DR.getStatus()&4 && DR.validateData()) {//check if data is available and consistent and if so ...
-        DR.setStatus(2); // ... mark dataset as "busy reading" and ...
-        (dataset + DR.getPos())->FUNCTION(); //... process it by calling its function
-        DR.setStatus(0); // release dataset to enable reception of next transmission
-      }
-    }
+    // process all datasets available (no interrupts need to be disabled for this)
+    DR.dispatch();
 
     // task has been executed -> set counter to 0
     check_data_available_loop_counter = 0;
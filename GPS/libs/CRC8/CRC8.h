@@ -0,0 +1,75 @@
+/*
+  "CRC8"
+  library calculating the CRC8 (Dallas/Maxim, polynomial x^8+x^5+x^4+1, reflected) of the datasets exchanged
+  by "DataTransmitter" and "DataReceiver"
+  V1.0 / Copyright (C) 2017, T.Rode (DL1DUZ)
+
+  Permission is granted to use, copy, modify, and distribute this software
+  and documentation for non-commercial purposes.
+
+  Required ressources:
+   - 256 byte of flash (lookup table) or none (bitwise calculation, see CRC8_USE_TABLE)
+*/
+
+#ifndef CRC8_h_
+#define CRC8_h_
+
+#if (ARDUINO >= 100)
+#include <Arduino.h>
+#else
+#include <WProgram.h>
+#endif
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+#if defined(__AVR__)
+#include <util/crc16.h>
+#endif
+
+//################################################################################################################
+//definitions
+//################################################################################################################
+
+// 1 -> a 256 byte lookup table in flash is used (fast); 0 -> the CRC is calculated bit by bit (no table)
+// CRC8.cpp and the libraries using it are compiled separately, so a #define in the sketch does not reach them:
+// change the setting here or pass it to the compiler for all files ("-DCRC8_USE_TABLE=0")
+#ifndef CRC8_USE_TABLE
+#define CRC8_USE_TABLE 1
+#endif
+
+// the reflected polynomial
+const uint8_t CRC8_POLYNOMIAL = 0x8C;
+
+// the CRC of a single byte (CRC register xor data byte), calculated bit by bit at compile time
+constexpr uint8_t crc8Bitwise(const uint8_t VALUE, const uint8_t BITS = 8) {
+  return BITS ? crc8Bitwise((VALUE & 1) ? (VALUE >> 1) ^ CRC8_POLYNOMIAL : (VALUE >> 1), BITS - 1) : VALUE;
+}
+
+#if CRC8_USE_TABLE
+extern const uint8_t CRC8_TABLE[256] PROGMEM;
+#endif
+
+//################################################################################################################
+
+class CRC8Class {
+
+public:
+// feeds one byte into the CRC register and returns the new CRC
+  static inline uint8_t update(const uint8_t CRC_VALUE, const uint8_t DATA) {
+#if CRC8_USE_TABLE
+    return pgm_read_byte(CRC8_TABLE + uint8_t(CRC_VALUE ^ DATA));
+#elif defined(__AVR__)
+    return _crc_ibutton_update(CRC_VALUE, DATA);
+#else
+    return crc8Bitwise(CRC_VALUE ^ DATA);
+#endif
+  }
+
+// returns the CRC of a dataset (the ID followed by SIZE byte of data)
+  uint8_t crcCalculation(const uint8_t ID, const uint8_t* DATA, const uint8_t SIZE);
+
+};
+
+extern CRC8Class CRC;
+
+#endif // CRC8_h_
@@ -2,16 +2,19 @@
   "DataReceiver"
   Library supporting wireless or wire-bound serial data broadcasting
   (e.g. sensor data via a 2-wire connection or radio broadcast on an ISM-frequency)
-  The transmission is DC-free (Manchester-coded) and error-checked (CRC8)
-  Requires library "CRCGenerator"
+  The transmission is DC-free (Manchester-coded), error-checked (CRC8) and optionally error-corrected
+  (Hamming(8,4), for datasets with FEC_FLAG set in their ID)
+  Requires libraries "CRC8" and "HammingFEC"
   
-  V1.1 / Copyright (C) 2017, T.Rode (DL1DUZ)
+  V1.6 / Copyright (C) 2017, T.Rode (DL1DUZ)
 
   Permission is granted to use, copy, modify, and distribute this software
   and documentation for non-commercial purposes.
 
   Required ressources:
    - 1 digital, interrupt-capable input pin
+   - or the input capture pin of timer 1 (ICP1, DR_ICP_PIN); the edges will then be timestamped by hardware
+     (0.5µs resolution) and timer 1 can't be used otherwise
 */
 
 #ifndef DataReceiver_h_
@@ -24,7 +27,8 @@
 #endif
 
 #include <stdint.h>
-#include <CRCGenerator.h>
+#include <CRC8.h>
+#include <HammingFEC.h>
 
 //################################################################################################################
 //definitions
@@ -32,11 +36,59 @@
 
 typedef void (*f_ptr)(); // funktion pointer
 
+// the max. number of receive buffers (slots) of the ring
+const uint8_t DR_MAX_SLOTS = 4;
+
+// the pin connected to the input capture unit of timer 1 (ICP1); a receiver connected to any other pin is
+// timestamped by "micros()" within a pin change interrupt; the code using timer 1 is only compiled, if
+// DR_ICP_AVAILABLE is 1
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega168__)
+#define DR_ICP_AVAILABLE 1
+const uint8_t DR_ICP_PIN = 8;
+#else
+#define DR_ICP_AVAILABLE 0
+const uint8_t DR_ICP_PIN = 0xFF;
+#endif
+
+// passed as BYTE_RATE to "init": the byte rate is detected from the preamble of each dataset (4...255 Byte/s;
+// 10...255 Byte/s at DR_ICP_PIN)
+const uint8_t DR_AUTO_BAUD = 0;
+
+// the size of a receive buffer [byte] providing SLOTS slots for datasets of up to MAX_SIZE byte
+constexpr uint16_t drBufferSize(const uint8_t SLOTS, const uint8_t MAX_SIZE) {
+  return SLOTS*(MAX_SIZE + 2);
+}
+
+// the size of the data section of a slot required by a dataset (datasets with FEC_FLAG set in their ID are
+// received as codewords, see "HammingFEC")
+constexpr uint8_t drFrameSize(const uint8_t ID, const uint8_t SIZE) {
+  return (ID & FEC_FLAG) ? fecEncodedSize(SIZE) - 1 : SIZE;
+}
+
 // structure containing all relevant parameter of a dataset
 struct dset_r {
   uint8_t ID; // the ID of the dataset
   uint8_t SIZE; // number of elements
   f_ptr FUNCTION; // a function to be called for data-processing
+  uint16_t delivered; // the number of datasets with this ID handed over valid (see "getDelivered")
+};
+
+// the number of classes of the inter-frame gap histogram (see "dr_stats")
+const uint8_t DR_GAP_BINS = 8;
+
+// the link quality counters (see "getStats"); all of them saturate at 65535
+struct dr_stats {
+  uint16_t preambles; // preambles the receiver locked to
+  uint16_t short_intervals; // receptions aborted by an interval shorter than T1 (noise, spikes)
+  uint16_t long_intervals; // receptions aborted by an interval longer than T3 (signal lost)
+  uint16_t unknown_ids; // datasets with an ID not found in "dset_r"
+  uint16_t dropped; // datasets dropped because all slots were in use
+  uint16_t crc_errors; // datasets discarded because of a CRC mismatch
+  uint16_t fec_corrections; // bit errors corrected by the forward error correction
+  uint16_t delivered; // datasets handed over valid (all IDs)
+  // the time between the beginnings of two datasets handed over by the isr: class i counts gaps < 2^i*1.024s,
+  // the last one all longer gaps
+  uint16_t gaps[DR_GAP_BINS];
 };
 
 //################################################################################################################
@@ -46,10 +98,17 @@ class DataReceiverClass {
 public:
 
   uint8_t init(const uint8_t BYTE_RATE, const uint8_t RECEIVER_PIN, dset_r* d_set,
-            const uint8_t DATASET_COUNT);
+            const uint8_t DATASET_COUNT, const uint8_t SLOTS = 2);
+  uint8_t init(const uint8_t BYTE_RATE, const uint8_t RECEIVER_PIN, dset_r* d_set,
+            const uint8_t DATASET_COUNT, uint8_t* BUFFER, const uint16_t BUFFER_SIZE);
 
   void enableReceiverInput(const uint8_t ENABLE);
   dset_r createDataset(const uint8_t ID, const uint8_t SIZE, const f_ptr FUNCTION);
+// creates a dataset of the size of the structure T
+  template<typename T> dset_r createDataset(const uint8_t ID, const f_ptr FUNCTION) {
+    static_assert(sizeof(T) < 256, "a dataset must not exceed 255 byte");
+    return createDataset(ID, sizeof(T), FUNCTION);
+  }
   void setStatus(uint8_t stat);
   uint8_t getStatus();
   uint32_t getTimestamp();
@@ -59,18 +118,53 @@ public:
   uint8_t validateData();
   uint8_t dataTransfer(const void* X, const uint16_t SCOPE, const uint8_t POS, const uint8_t WRITE);
   uint8_t* getDataArray();
+// returns the data section of the oldest dataset as a structure T (no copy; valid until its slot is released)
+  template<typename T> const T* getDataset() {
+    return (const T*) getDataArray();
+  }
+  uint16_t getDropped();
+  uint16_t getCRCErrors();
+  uint16_t getFECCorrections();
+  uint16_t getDelivered(const uint8_t POS);
+  void getStats(dr_stats* STATS);
+  void resetStats();
+  uint8_t getByteRate();
+  void onDatasetReady(const f_ptr FUNCTION);
+  uint8_t dispatch();
+
+#if DR_ICP_AVAILABLE
+  void captureIsr(); // For internal use only / do not call!!!
+#endif
 
 private:
 
   // Flag holding the init-state of this routine
   uint8_t is_initialized = 0;
+  // Flag indicating that the edges are timestamped by the input capture unit of timer 1
+  uint8_t use_icp = 0;
+  // the timestamp [μs] of the last edge (pin change front end) and the timer 1 value captured at it (input
+  // capture front end)
+  uint32_t last_micros = 0;
+  uint16_t last_capture;
   // holding the receiver input pin
   uint8_t receiver_input = 0;
-  // time step thresholds [μs] for given Byte-rate
+  // time step thresholds [ticks of the timestamp: 1μs or those of timer 1 in input capture mode], derived from
+  // the half-bit period
   uint16_t T1, T2, T3;
-  // latency between beginning of transmission and recognition of ID
-  uint16_t Tl;
-  // for synchronisation purposes
+  // the half-bit period [ticks/16], taken from the preamble and tracked while receiving
+  uint32_t period;
+  // the range of half-bit periods [ticks] accepted from the preamble, the interval preceding the current one and
+  // a flag indicating that it followed a gap (see "decodeEdge")
+  uint16_t h_min, h_max;
+  uint16_t last_dt;
+  uint8_t after_gap;
+  // the ticks of the timestamp per 1/16s and the factor converting the half-bit period into the latency [ms]
+  // between beginning of transmission and recognition of the ID (*tl_factor/2048)
+  uint32_t tick_rate;
+  uint8_t tl_factor;
+  // the half-bit period [ticks] of the last dataset received
+  volatile uint16_t last_period = 0;
+  // flag indicating that the preamble has been received (the half-bit period is known)
   uint8_t int_counter;
   // counting the bytes already receiver
   uint16_t byte_counter;
@@ -80,29 +174,59 @@ private:
   uint8_t byte_value;
   // value of the previous bit received
   uint8_t prev_bit;
-  // the position of the dataset corresponding to the ID-value currently stored in the array
+  // the position of the dataset corresponding to the ID-value currently being received
   uint8_t pos;
   // flag controlling the datastream processing (used at ISR)
   uint8_t skip_next_short;
+  // the CRC of the bytes received so far (ID and data)
+  uint8_t crc;
+  // the number of bytes of the dataset being received (ID, CRC and data or codewords)
+  uint16_t frame_size;
 
 // pointer to dset_r-array
   dset_r* dataset;
 // the number of datasets (size of "dataset")
-  uint8_t dataset_count;
-// pointer to an array containing the received data
+  uint8_t dataset_count = 0;
+// pointer to the ring of receive buffers (slots), each holding ID, CRC and data of one dataset
   uint8_t* data_array;
-// the size of the data array
+// the size of the data section of a slot
   uint8_t array_size = 0;
-// the status of the data array (idle = 0; busy writing = 1; busy reading = 2; data available = 4)
-  volatile uint8_t status = 0; 
-// the timestamp [ms] when the data was received
-  uint32_t timestamp;
+// the number of slots (1, 2 or 4) and the slot being written by the isr
+  uint8_t slot_count;
+  uint8_t* write_array;
+// the number of datasets completed by the isr (producer) and released by the main loop (consumer); both are
+// free-running, so the slots in use are [tail...head-1] and the isr only starts a new one if head-tail < slot_count
+  volatile uint8_t head = 0;
+  volatile uint8_t tail = 0;
+// flags indicating that a dataset is being received (set by the isr) and that the oldest one is being read
+  volatile uint8_t writing = 0;
+  uint8_t reading = 0;
+// the position in "dataset", the timestamp [ms] and the state (see below) of the dataset in each slot
+  uint8_t slot_pos[DR_MAX_SLOTS];
+  uint32_t slot_timestamp[DR_MAX_SLOTS];
+  uint8_t slot_state[DR_MAX_SLOTS];
+// the link quality counters (updated by the isr and, for datasets with forward error correction, by
+// "validateData"; read with interrupts disabled)
+  dr_stats stats = {};
+// the timestamp [ms] of the last dataset handed over by the isr and a flag indicating that there is one
+  uint32_t last_frame;
+  uint8_t has_last_frame = 0;
+// a function called by the isr whenever a dataset has been received completely
+  f_ptr ready_function = NULL;
 
   static DataReceiverClass *this_instance;
   static void isr();
   void DRisr();
+  void decodeEdge(uint16_t dt);
+  void trackPeriod(uint16_t half);
+  void setThresholds();
+  static uint8_t getMaxSize(const dset_r* dsets, const uint8_t DATASET_COUNT);
+  uint8_t decodeFEC();
+  void countGap(uint32_t timestamp);
+  void countDelivered(uint8_t slot);
   void resetReception();
   void storeData();
+  uint8_t* readArray();
 
 };
 
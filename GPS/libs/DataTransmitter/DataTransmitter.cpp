@@ -2,10 +2,11 @@
   "DataTransmitter"
   Library supporting wireless or wire-bound serial data broadcasting
   (e.g. sensor data via a 2-wire connection or radio broadcast on an ISM-frequency)
-  The transmission is DC-free (Manchester-coded) and error-checked (CRC8)
-  Requires library "CRCGenerator"
+  The transmission is DC-free (Manchester-coded), error-checked (CRC8) and optionally error-corrected
+  (Hamming(8,4), for datasets with FEC_FLAG set in their ID)
+  Requires libraries "CRC8" and "HammingFEC"
   
-  V1.0 / Copyright (C) 2017, T.Rode (DL1DUZ)
+  V1.2 / Copyright (C) 2017, T.Rode (DL1DUZ)
 
   Permission is granted to use, copy, modify, and distribute this software
   and documentation for non-commercial purposes.
@@ -38,6 +39,25 @@ ISR(TIMER2_COMPA_vect) {
 //private functions
 //##############################################################################################################
 
+// returns the next byte to be transmitted with forward error correction; CRC and data are encoded block by block
+// (4 byte -> 8 byte of interleaved codewords), the last block is padded with 0
+
+uint8_t DataTransmitterClass::nextFECByte() {
+  uint8_t i = byte_counter & 7;
+
+  if(!i) {
+    uint8_t in[4];
+    uint8_t pos = byte_counter >> 1; // the position of the first byte of this block in CRC + data
+    for(uint8_t j=0; j<4; ++j, ++pos) {
+      if(!pos) { in[j] = crc; }
+      else { in[j] = (pos <= size) ? *(data + pos - 1) : 0; }
+    }
+    FEC.encodeBlock(in, fec_block);
+  }
+
+  return fec_block[i];
+}
+
 //################################################################################################################
 //public functions
 //################################################################################################################
@@ -74,7 +94,7 @@ void DataTransmitterClass::isr() {
         }
       }
       else {
-        curr_byte = *(data+byte_counter);
+        curr_byte = fec ? nextFECByte() : *(data+byte_counter);
         block_size = 19;
         ++byte_counter;
       }
@@ -153,7 +173,9 @@ dset_t DataTransmitterClass::createDataset(const void* X, const uint8_t ID, cons
 
 /*
 transmits a set of Byte-data including ID and calculated CRC8-value for validation (LSB first)
-in case of an ongoing transmission or SIZE == 0 this function will return 0, otherwise 1
+if FEC_FLAG is set in the ID, CRC and data are transmitted as interleaved Hamming(8,4) codewords (twice as many
+byte, SIZE must not exceed FEC_MAX_SIZE)
+in case of an ongoing transmission, SIZE == 0 or SIZE too big this function will return 0, otherwise 1
 
 "DSET" -> a pointer to the dataset
 */
@@ -161,20 +183,31 @@ in case of an ongoing transmission or SIZE == 0 this function will return 0, oth
 uint8_t DataTransmitterClass::transmitData(const dset_t DSET) {
   uint8_t commenced = 0;
 
-  if(!bytes && DSET.SIZE) {
-    bytes = DSET.SIZE;
+  if(!bytes && DSET.SIZE && (!(DSET.ID & FEC_FLAG) || DSET.SIZE <= FEC_MAX_SIZE)) {
+    fec = DSET.ID & FEC_FLAG;
+    size = DSET.SIZE;
     data = DSET.data;
-    // two sync-bits + ID + CRC
-    curr_byte = CRC.crcCalculation(DSET.ID, DSET.data, DSET.SIZE);
-    curr_byte <<= 8;
-    curr_byte += DSET.ID;
+    crc = CRC.crcCalculation(DSET.ID, DSET.data, DSET.SIZE);
+    if(fec) {
+      // two sync-bits + ID; the CRC is sent with the data
+      bytes = fecEncodedSize(size);
+      curr_byte = DSET.ID;
+      block_size = 23;
+    }
+    else {
+      // two sync-bits + ID + CRC
+      bytes = size;
+      curr_byte = crc;
+      curr_byte <<= 8;
+      curr_byte += DSET.ID;
+      block_size = 39;
+    }
     curr_byte <<= 2;
     curr_byte += 3;
 
     step = 1; // each symbol requires two steps to transmit
     prev_symbol = 0; // equal to first symbol (bit) to be transmitted (which is 1)
     byte_counter = 0;
-    block_size = 39;
     pin_value = 1;
   
     // start timer 2
@@ -2,10 +2,11 @@
   "DataTransmitter"
   Library supporting wireless or wire-bound serial data broadcasting
   (e.g. sensor data via a 2-wire connection or radio broadcast on an ISM-frequency)
-  The transmission is DC-free (Manchester-coded) and error-checked (CRC8)
-  Requires library "CRCGenerator"
+  The transmission is DC-free (Manchester-coded), error-checked (CRC8) and optionally error-corrected
+  (Hamming(8,4), for datasets with FEC_FLAG set in their ID)
+  Requires libraries "CRC8" and "HammingFEC"
   
-  V1.0 / Copyright (C) 2017, T.Rode (DL1DUZ)
+  V1.2 / Copyright (C) 2017, T.Rode (DL1DUZ)
 
   Permission is granted to use, copy, modify, and distribute this software
   and documentation for non-commercial purposes.
@@ -25,7 +26,8 @@
 #endif
 
 #include <stdint.h>
-#include <CRCGenerator.h>
+#include <CRC8.h>
+#include <HammingFEC.h>
 
 //################################################################################################################
 //definitions
@@ -46,6 +48,11 @@ public:
 
   void init(const uint8_t BYTE_RATE, const uint8_t TRANSMITTER_PIN, const uint8_t IS_LOW_ACTIVE);
   dset_t createDataset(const void* X, const uint8_t ID, const uint8_t SCOPE);
+// creates a dataset transmitting the structure X directly (it must not be changed until it has been sent)
+  template<typename T> dset_t createDataset(const T* X, const uint8_t ID) {
+    static_assert(sizeof(T) < 256, "a dataset must not exceed 255 byte");
+    return createDataset((const void*) X, ID, sizeof(T));
+  }
   uint8_t dataTransfer(const void* X, const uint16_t SCOPE, const dset_t DSET, const uint8_t POS,
                        const uint8_t WRITE);
   uint8_t transmitData(const dset_t DSET);
@@ -54,6 +61,8 @@ public:
 
 private:
 
+  uint8_t nextFECByte();
+
   uint8_t pin;
   uint8_t* data;
   volatile uint8_t bytes = 0;
@@ -64,6 +73,11 @@ private:
   uint32_t curr_byte;
   uint8_t block_size;
   uint8_t pin_value = 0;
+  // forward error correction: flag, size of the dataset, its CRC and the block of codewords being transmitted
+  uint8_t fec;
+  uint8_t size;
+  uint8_t crc;
+  uint8_t fec_block[8];
 
   uint8_t prescaler = 0;
 
@@ -0,0 +1,72 @@
+/*
+  "GPSDatasets"
+  layout of the datasets broadcast by the GPS-module ("GPS_beacon", library "DataTransmitter") and received by
+  the WSPR beacon ("DataReceiver")
+  V1.0 / Copyright (C) 2017, T.Rode (DL1DUZ)
+
+  Permission is granted to use, copy, modify, and distribute this software
+  and documentation for non-commercial purposes.
+
+  Both sides use the same structures: the transmitter sends them as they are (LSB first) and the receiver reads
+  the fields straight from its receive buffer. The ID of a dataset doubles as the version of its layout; any
+  change of a layout requires a new ID, so that receivers not knowing it ignore it instead of misreading it.
+*/
+
+#ifndef GPSDatasets_h_
+#define GPSDatasets_h_
+
+#include <stdint.h>
+#include <stddef.h>
+
+//################################################################################################################
+//definitions
+//################################################################################################################
+
+// the IDs (layout versions) of the datasets (0...127, FEC_FLAG marks transmission with forward error correction)
+const uint8_t GPS_DATASET_ID = 0;
+const uint8_t ASTRO_DATASET_ID = 1;
+
+// position, altitude, speed, locator, outside temperature and time (dataset 0)
+struct __attribute__((packed)) gps_dataset {
+  uint8_t lat_deg; // GPS latitude in degree
+  uint8_t lat_min; // GPS latitude in minutes
+  uint8_t lat_sec; // GPS latitude in seconds
+  char lat_o; // GPS latitude orientation ('N', 'n', 'S', 's')
+  uint8_t long_deg; // GPS longitude in degree
+  uint8_t long_min; // GPS longitude in minutes
+  uint8_t long_sec; // GPS longitude in seconds
+  char long_o; // GPS longitude orientation ('E', 'e', 'W', 'w')
+  uint16_t alt; // GPS altitude in meter
+  uint8_t sog; // GPS speed over ground in km/h
+  uint8_t sat; // GPS number of satellites used
+  char locator[7]; // 6-character Maidenhead locator (null-terminated)
+  int16_t temp; // outside temperature * 16 (0x8000 -> sensor error)
+  uint32_t utc; // the current UTC (time_t)
+};
+
+// rise and set times, position and phase of the Sun and the Moon (dataset 1)
+struct __attribute__((packed)) astro_dataset {
+  uint8_t sog; // GPS speed over ground in km/h
+  uint32_t rise_set[4]; // Sunrise, Sunset, Moonrise, Moonset (time_t)
+  uint32_t timestamp; // the time the following data was calculated for (time_t)
+  int32_t sun_az; // the Sun's azimuth in degree*100 (North = 0, East = 90, South = 180, West = 270)
+  int16_t sun_alt; // the Sun's altitude in degree*100
+  int32_t moon_az; // the Moon's azimuth in degree*100
+  int16_t moon_alt; // the Moon's altitude in degree*100
+  int16_t moon_phase; // the Moon's phase in %*100 (positive for increasing phase)
+};
+
+// the layouts on air; a failing check means the layout has been changed (-> new ID)
+static_assert(sizeof(gps_dataset) == 25 && offsetof(gps_dataset, alt) == 8 &&
+              offsetof(gps_dataset, locator) == 12 && offsetof(gps_dataset, temp) == 19 &&
+              offsetof(gps_dataset, utc) == 21, "layout of dataset 0 has been changed");
+static_assert(sizeof(astro_dataset) == 35 && offsetof(astro_dataset, rise_set) == 1 &&
+              offsetof(astro_dataset, timestamp) == 17 && offsetof(astro_dataset, sun_az) == 21 &&
+              offsetof(astro_dataset, moon_az) == 27 && offsetof(astro_dataset, moon_phase) == 33,
+              "layout of dataset 1 has been changed");
+
+// the size of the biggest dataset (e.g. to size the receive buffer)
+const uint8_t GPS_DATASETS_MAX_SIZE = (sizeof(gps_dataset) > sizeof(astro_dataset)) ? sizeof(gps_dataset) :
+                                                                                      sizeof(astro_dataset);
+
+#endif // GPSDatasets_h_
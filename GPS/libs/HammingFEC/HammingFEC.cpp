@@ -0,0 +1,89 @@
+/*
+  "HammingFEC"
+  library providing the forward error correction of the datasets exchanged by "DataTransmitter" and
+  "DataReceiver": each nibble is sent as an extended Hamming(8,4) codeword (corrects 1 and detects 2 bit errors
+  per codeword) and the codewords are bit-interleaved in blocks of 8, so that a burst of up to 8 bit errors is
+  corrected as well
+  V1.0 / Copyright (C) 2017, T.Rode (DL1DUZ)
+
+  Permission is granted to use, copy, modify, and distribute this software
+  and documentation for non-commercial purposes.
+
+  Required ressources:
+   - 272 byte of flash (code tables)
+*/
+
+//################################################################################################################
+//includes
+//################################################################################################################
+
+#include <HammingFEC.h>
+
+//################################################################################################################
+//declarations
+//################################################################################################################
+
+// the code tables, generated by the compiler
+#define FEC_C4(i) fecCodeword(i), fecCodeword(i+1), fecCodeword(i+2), fecCodeword(i+3)
+#define FEC_N4(i) fecNibble(i), fecNibble(i+1), fecNibble(i+2), fecNibble(i+3)
+#define FEC_N16(i) FEC_N4(i), FEC_N4(i+4), FEC_N4(i+8), FEC_N4(i+12)
+#define FEC_N64(i) FEC_N16(i), FEC_N16(i+16), FEC_N16(i+32), FEC_N16(i+48)
+
+const uint8_t FEC_CODEWORDS[16] PROGMEM = { FEC_C4(0), FEC_C4(4), FEC_C4(8), FEC_C4(12) };
+const uint8_t FEC_NIBBLES[256] PROGMEM = { FEC_N64(0), FEC_N64(64), FEC_N64(128), FEC_N64(192) };
+
+static_assert(fecCodeword(0) == 0 && fecCodeword(15) == 0xFF && fecNibble(fecCodeword(9) ^ 0x40) == (9 | 0x10) &&
+              (fecNibble(fecCodeword(9) ^ 0x41) & 0x20), "Hamming(8,4) table generator is broken");
+
+//################################################################################################################
+//private functions
+//################################################################################################################
+
+// transposes a block of 8x8 bit: bit c of byte r becomes bit r of byte c (so it's its own inverse)
+
+void HammingFECClass::interleave(const uint8_t* IN, uint8_t* out) {
+  for(uint8_t r=0; r<8; ++r) {
+    uint8_t value = 0;
+    for(uint8_t c=8; c>0; --c) {
+      value = (value << 1) | ((IN[c-1] >> r) & 1);
+    }
+    out[r] = value;
+  }
+}
+
+//################################################################################################################
+//public functions
+//################################################################################################################
+
+// encodes 4 byte (8 nibbles, low nibble first) into a block of 8 interleaved codewords
+
+void HammingFECClass::encodeBlock(const uint8_t* BYTES, uint8_t* block) {
+  uint8_t codewords[8];
+  for(uint8_t i=0; i<4; ++i) {
+    codewords[i<<1] = pgm_read_byte(FEC_CODEWORDS + (BYTES[i] & 0x0F));
+    codewords[(i<<1) + 1] = pgm_read_byte(FEC_CODEWORDS + (BYTES[i] >> 4));
+  }
+  interleave(codewords, block);
+}
+
+//################################################################################################################
+
+// decodes a block of 8 interleaved codewords into 4 byte; returns the number of bit errors corrected or
+// FEC_UNCORRECTABLE (if a codeword had more than one bit error; the data bits are taken as received then)
+
+uint8_t HammingFECClass::decodeBlock(const uint8_t* BLOCK, uint8_t* bytes) {
+  uint8_t codewords[8];
+  uint8_t corrected = 0;
+  interleave(BLOCK, codewords);
+  for(uint8_t i=0; i<4; ++i) {
+    uint8_t lo = pgm_read_byte(FEC_NIBBLES + codewords[i<<1]);
+    uint8_t hi = pgm_read_byte(FEC_NIBBLES + codewords[(i<<1) + 1]);
+    bytes[i] = (lo & 0x0F) | (hi << 4);
+    if((lo | hi) & 0x20) { corrected = FEC_UNCORRECTABLE; }
+    else if(corrected != FEC_UNCORRECTABLE) { corrected += ((lo >> 4) & 1) + ((hi >> 4) & 1); }
+  }
+
+  return corrected;
+}
+
+HammingFECClass FEC;
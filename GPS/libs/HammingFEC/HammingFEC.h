@@ -0,0 +1,93 @@
+/*
+  "HammingFEC"
+  library providing the forward error correction of the datasets exchanged by "DataTransmitter" and
+  "DataReceiver": each nibble is sent as an extended Hamming(8,4) codeword (corrects 1 and detects 2 bit errors
+  per codeword) and the codewords are bit-interleaved in blocks of 8, so that a burst of up to 8 bit errors is
+  corrected as well
+  V1.0 / Copyright (C) 2017, T.Rode (DL1DUZ)
+
+  Permission is granted to use, copy, modify, and distribute this software
+  and documentation for non-commercial purposes.
+
+  Required ressources:
+   - 272 byte of flash (code tables)
+*/
+
+#ifndef HammingFEC_h_
+#define HammingFEC_h_
+
+#if (ARDUINO >= 100)
+#include <Arduino.h>
+#else
+#include <WProgram.h>
+#endif
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+//################################################################################################################
+//definitions
+//################################################################################################################
+
+// datasets with this bit set in their ID are transmitted with forward error correction (so IDs 0...127 are
+// available for either kind)
+const uint8_t FEC_FLAG = 0x80;
+
+// the max. size of a dataset transmitted with forward error correction
+const uint8_t FEC_MAX_SIZE = 123;
+
+// returned by "decodeBlock", if a codeword had more than one bit error
+const uint8_t FEC_UNCORRECTABLE = 0xFF;
+
+// the number of byte transmitted for CRC and data of a dataset of SIZE byte (2 codewords per byte, padded to
+// complete blocks of 8)
+constexpr uint16_t fecEncodedSize(const uint8_t SIZE) {
+  return ((SIZE + 4)/4)*8;
+}
+
+// the number of 1-bits
+constexpr uint8_t fecOnes(const uint8_t X) {
+  return X ? (X & 1) + fecOnes(X >> 1) : 0;
+}
+
+// the Hamming parity bits (4...6) of a nibble
+constexpr uint8_t fecParity(const uint8_t N) {
+  return (((N ^ (N >> 1) ^ (N >> 3)) & 1) << 4) | (((N ^ (N >> 2) ^ (N >> 3)) & 1) << 5) |
+         ((((N >> 1) ^ (N >> 2) ^ (N >> 3)) & 1) << 6);
+}
+
+// the codeword of a nibble: data in bits 0...3, Hamming parity in bits 4...6, overall parity in bit 7
+constexpr uint8_t fecCodeword(const uint8_t N) {
+  return N | fecParity(N) | ((fecOnes(N | fecParity(N)) & 1) << 7);
+}
+
+// the nibble (bits 0...3) a received codeword decodes to; bit 4 is set, if a bit error has been corrected, bit 5,
+// if the codeword has more than one (the data bits are returned as received then)
+constexpr uint8_t fecNibble(const uint8_t C, const uint8_t N = 0) {
+  return (N == 16) ? ((C & 0x0F) | 0x20) :
+         (fecOnes(fecCodeword(N) ^ C) == 0) ? N :
+         (fecOnes(fecCodeword(N) ^ C) == 1) ? (N | 0x10) : fecNibble(C, N + 1);
+}
+
+extern const uint8_t FEC_CODEWORDS[16] PROGMEM;
+extern const uint8_t FEC_NIBBLES[256] PROGMEM;
+
+//################################################################################################################
+
+class HammingFECClass {
+
+public:
+// encodes 4 byte (8 nibbles) into a block of 8 interleaved codewords
+  void encodeBlock(const uint8_t* BYTES, uint8_t* block);
+// decodes a block of 8 interleaved codewords into 4 byte; returns the number of bit errors corrected or
+// FEC_UNCORRECTABLE
+  uint8_t decodeBlock(const uint8_t* BLOCK, uint8_t* bytes);
+
+private:
+  static void interleave(const uint8_t* IN, uint8_t* out);
+
+};
+
+extern HammingFECClass FEC;
+
+#endif // HammingFEC_h_
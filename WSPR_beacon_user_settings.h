@@ -84,6 +84,33 @@ const uint8_t ALT_SPEED = 1; // shows a screen displaying the current altitude a
 // astromechanics. So if you're interested in the heavens above, you may want to activate those features below.
 const uint8_t SUN = 1; // shows a screen displaying time of sunrise & sunset
 const uint8_t MOON = 1; // shows a screen displaying time of moonrise & moonset plus the Moon's phase (e.g. 53% decreasing)
+const uint8_t LINK_STATS = 1; // shows a screen displaying the quality of the link to the GPS-module (receiver counters)
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// tickless idle mode (0 = off, 1 = on) /// if on, the loop will skip all cycles without due tasks and put the MCU to
+// sleep until the next event instead of busy-waiting; reduces power consumption (solar/battery sites). The MCU sleeps
+// in AVR idle mode, during transmissions in power-save mode (woken by timer 2) if neither SWR-meter, 1PPS-input nor
+// diagnostics are on and no dataset of the GPS-module is expected
+const uint8_t TICKLESS_IDLE = 0;
+
+// serial diagnostics (0 = off, 1 = on) /// if on, reports can be requested at runtime by sending a single character
+// at 9600 baud: 'p' = power/cycle accounting of the main loop, 's' = scheduler statistics, 'r' = reset statistics,
+// 'w' = per-band SWR statistics (comma separated, see library "SWRStats"), 'l' = GPS-link quality (receiver counters)
+// Note: the serial TX-line is shared with the LCD backlight (pin 1), so backlight control is lost while this is on.
+const uint8_t DIAGNOSTICS = 0;
+
+// scheduler instrumentation (0 = off, 1 = on) /// if on, the runtime of the loop and the execution times of all tasks
+// are recorded (overrun histogram, worst case and mean); leave off for release builds (the code will be omitted)
+const uint8_t SCHEDULER_STATS = 0;
+
+//~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+// "GPS 1PPS-signal connected?" (0 = no, 1 = yes) /// if connected (wire from the GPS-module's 1PPS-output), the first
+// symbol of each transmission will be timed by hardware to start exactly 1.000s after the even minute's PPS-edge;
+// otherwise the start is derived from the system clock (typical error some 10ms)
+// Note: a macro, because it decides whether the pin change interrupt vector of the PPS-input is occupied.
+#define PPS_INSTALLED 0
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
@@ -103,10 +130,23 @@ const uint8_t D4_PIN = 11;
 const uint8_t D5_PIN = 10;
 const uint8_t D6_PIN = 9;
 const uint8_t D7_PIN = 8;
+// R/W (set to HD44780_NO_RW if R/W is tied to GND; if connected, the LCD's busy flag will be read instead of
+// waiting for the maximum execution time)
+const uint8_t RW_PIN = HD44780_NO_RW;
+// LED-backlight; connected to pin 3 (OC2B) the pulsing will be generated by hardware PWM (the "transmitter
+// disabled" switch then has to be moved to another pin)
 const uint8_t LED = 1;
 
-// GPS-module receiver (digital pin capable of triggering interrupts)
+// GPS-module receiver (digital pin capable of triggering interrupts); on pin 8 (ICP1) the edges are timestamped by
+// the input capture unit of timer 1 (LCD D7 has to be moved then; not possible together with PPS_INSTALLED,
+// which needs timer 1 as well)
 const uint8_t GPS_INPUT_PIN = 2;
+// 1 -> datasets sent by the GPS-module with forward error correction ("USE_FEC" in GPS_beacon) are accepted as well
+// (costs 72 byte of RAM for the bigger receive buffer)
+const uint8_t GPS_FEC = 0;
+
+// GPS-module 1PPS-output (analog pin A0...A3 used as digital input / pin change interrupt)
+const uint8_t PPS_PIN = A0;
 
 // End user settings
 
@@ -21,9 +21,18 @@
 #include <AD9850.h>
 // Receiver-library to listen to transmissions from GPS-module
 #include <DataReceiver.h>
+// Layout of the datasets transmitted by the GPS-module
+#include <GPSDatasets.h>
 #include <util/atomic.h>
-
-#include <LiquidCrystal.h>
+#include <avr/sleep.h>
+#include <EEPROM.h>
+
+// Library providing division-free number formatting for the LCD
+#include <NumberFormat.h>
+// Library keeping per-band SWR statistics in EEPROM
+#include <SWRStats.h>
+// Library driving the HD44780-LCD by direct port access
+#include <HD44780.h>
 #include <TimeLib.h>
 
 #include "WSPR_beacon_user_settings.h"
@@ -83,15 +92,18 @@ const uint8_t TX_SWR_DISABLED[33] PROGMEM = "TX disabled due to SWR>3 at  --m";
 const uint8_t TX_GPS_DISABLED[33] PROGMEM = "no GSP-data ->  beacon disabled ";
 const uint8_t TX_HARDWARE_DISABLED[33] PROGMEM = "TX switched off by user         ";
 const uint8_t WAITING_FOR_GPS[33] PROGMEM = "waiting for datafrom GPS-module ";
-const uint8_t TIME_DATE[33] PROGMEM = "--:--:--      C ---. --.--.---- ";
+const uint8_t TIME_DATE[33] PROGMEM = "--:--:--     \337C ---. --.--.---- ";
 const uint8_t WEEKDAY_CODING[22] PROGMEM = "SunMonTueWedThuFriSat";
 const uint8_t ALT_SPEED_DISP[33] PROGMEM = "Altitude:    -m Speed:   -km/h  ";
 const uint8_t SUN_DISP[33] PROGMEM = "Sun: today --:--     today --:--";
 const uint8_t MOON_DISP[33] PROGMEM = "Moon:today --:--     today --:--";
 const uint8_t MOON_PHASE_DISP[33] PROGMEM = "  Moon's phase:    -% decreasing";
+const uint8_t COORDINATES_DISP[33] PROGMEM = " --\337 --' --\" -   --\337 --' --\" -  ";
+const uint8_t TX_SWR_DISABLED_ALL[33] PROGMEM = "TX disabled due to SWR>3     -- ";
+const uint8_t LINK_DISP[33] PROGMEM = "syn----  ok ----cor---- crc ----";
 
-// build LiquidCrystal-instance
-LiquidCrystal lcd(RS_PIN, ENABLE_PIN, D4_PIN, D5_PIN, D6_PIN, D7_PIN);
+// build HD44780-instance lcd(RS_PIN, ENABLE_PIN, D4_PIN, D5_PIN, D6_PIN, D7_PIN, RW_PIN)
+HD44780 lcd(RS_PIN, ENABLE_PIN, D4_PIN, D5_PIN, D6_PIN, D7_PIN, RW_PIN);
 
 // the number of characters at the LCD-display
 const uint8_t DISPLAY_SIZE = 32;
@@ -105,19 +117,95 @@ uint8_t lcd_content_last[DISPLAY_SIZE] = {0};
 uint8_t cursor_position = 0;
 // current cursor status (0==nothing; 1==only corsor; 2==only blinking; 3==blinking cursor)
 uint8_t cursor_status = 0;
+// the cursor status actually set at the LCD (after initialisation the cursor is off)
+uint8_t lcd_cursor_status = 0;
+
+// the LCD refresh queue: the changed characters are transferred by "serviceLCD" within the loop, limited to
+// LCD_TRANSACTIONS bus transactions (character or address command) per loop cycle
+const uint8_t LCD_TRANSACTIONS = 1;
+uint8_t lcd_refresh_pending = 0;
+// the next position to be compared with its last image and the position the next character would be
+// written to (0xFF == unknown or not within the visible area)
+uint8_t lcd_scan_pos = 0;
+uint8_t lcd_next_pos = 0xFF;
+// 1 -> the display will be cleared first (fewer transactions, if the new content has more blanks than unchanged
+// characters)
+uint8_t lcd_clear_pending = 0;
 
 // a pointer determining the active display content and its max. value
-const uint8_t MAX_DISP_CONTENT = 7;
+const uint8_t MAX_DISP_CONTENT = 8;
 uint8_t disp_content_pointer = 0;
-// a pointer determining the content to be on fast refresh
-uint8_t fast_refresh_pointer = 0;
 
-// the current LED-backlight brightness, the min value and change per step
-const uint8_t MIN_BRIGHTNESS = 30;
-uint8_t brightness;
+// the screens (a template and the fields to be formatted into it, see "SCREENS")
+const uint8_t SCREEN_STANDBY = 0;
+const uint8_t SCREEN_ON_AIR = 1;
+const uint8_t SCREEN_SWR_DISABLED = 2;
+const uint8_t SCREEN_SWR_DISABLED_ALL = 3;
+const uint8_t SCREEN_GPS_DISABLED = 4;
+const uint8_t SCREEN_HARDWARE_DISABLED = 5;
+const uint8_t SCREEN_WAITING_FOR_GPS = 6;
+const uint8_t SCREEN_USER_DATA = 7;
+const uint8_t SCREEN_TIME_DATE = 8;
+const uint8_t SCREEN_COORDINATES = 9;
+const uint8_t SCREEN_ALT_SPEED = 10;
+const uint8_t SCREEN_SUN = 11;
+const uint8_t SCREEN_MOON = 12;
+const uint8_t SCREEN_MOON_PHASE = 13;
+const uint8_t SCREEN_LINK = 14;
+const uint8_t NO_SCREEN = 0xFF;
+// the screen currently held by the LCD buffer
+uint8_t active_screen = NO_SCREEN;
+
+// the data sources of the screen fields; each source has a version counter to be incremented whenever its data
+// changes, so that only the affected fields will be re-formatted (static fields are only formatted once)
+const uint8_t SRC_STATIC = 0;
+const uint8_t SRC_CLOCK = 1;
+const uint8_t SRC_DATE = 2;
+const uint8_t SRC_GPS = 3;
+const uint8_t SRC_TEMP = 4;
+const uint8_t SRC_ASTRO = 5;
+const uint8_t SRC_SWR = 6;
+const uint8_t SRC_BAND = 7;
+const uint8_t SRC_COUNT = 8;
+uint8_t src_version[SRC_COUNT] = { 0 };
+// the source versions the fields of the active screen have been formatted with
+const uint8_t MAX_FIELDS = 8;
+uint8_t field_version[MAX_FIELDS];
+
+// a screen field: the cells it occupies (they will be restored from the template before re-formatting), its
+// data source and the function formatting the data into the LCD buffer
+struct screen_field {
+  uint8_t pos;
+  uint8_t width;
+  uint8_t source;
+  void (*format)(uint8_t pos, uint8_t width);
+};
+// a screen: the template and the list of fields
+struct display_screen {
+  const uint8_t *content;
+  const screen_field *fields;
+  uint8_t field_count;
+};
+
+// the LED-backlight's pulsing: timer 2 runs in fast PWM mode (1.024ms period), the brightness (duty cycle)
+// follows a gamma-corrected table from min (30) to max (255) and back, one step every BACKLIGHT_STEP_PERIODS
+// periods (27.6ms -> 3.5s per cycle)
+const uint8_t BACKLIGHT_STEPS = 64;
+const uint8_t BACKLIGHT_GAMMA[BACKLIGHT_STEPS] PROGMEM = {30, 30, 30, 30, 31, 31, 31, 32, 32, 33, 34, 35, 36, 37, 38,
+                                                          40, 41, 43, 44, 46, 48, 50, 52, 55, 57, 59, 62, 65, 68, 71,
+                                                          74, 77, 81, 84, 88, 92, 96, 100, 104, 108, 113, 117, 122,
+                                                          127, 132, 137, 143, 148, 154, 159, 165, 171, 178, 184, 190,
+                                                          197, 204, 211, 218, 225, 232, 240, 247, 255};
+const uint8_t BACKLIGHT_STEP_PERIODS = 27;
+// if the LED is connected to OC2B (pin 3), the PWM signal is generated by hardware; otherwise the timer's
+// interrupts switch the LED (2 interrupts per period)
+const uint8_t LED_HARDWARE_PWM = (LED == 3);
+volatile uint8_t *led_port;
+uint8_t led_mask;
+uint8_t brightness_step;
 int8_t brightness_change;
 uint8_t pulsing_on;
-uint8_t backlight_on_time_counter;
+uint8_t backlight_period_counter;
 
 // Variables/constants used by GPS
 uint8_t lat_long[4][2]; // longitude and latitude (lat_d, lat_m, lat_s, lat_o, long_d, long_m, long_s, long_o)
@@ -154,9 +242,26 @@ char band[4];
 // array holding the delta phase values for WSPR lower band limit @ 160m-10m
 // can be adjusted depending on the actual DDS clock frequency by calling setDeltaPhaseBase()
 uint32_t deltaphase_base[BAND_COUNT];
-// variables holding the reflected SWR-readings
+// variables holding the forward SWR-reading
 uint16_t fwd_value;
-uint32_t ref_value;
+// thresholds of the SWR-calculation / SWR*10 reaches k (k = 11...98), if the reflection coefficient rho*2^21
+// reaches SWR_THRESHOLD[k-11] = ceil(2^21*(k-10)/(k+10)) (derived from SWR = (1+rho)/(1-rho))
+const uint8_t SWR_THRESHOLDS = 88;
+const uint32_t SWR_THRESHOLD[SWR_THRESHOLDS] PROGMEM = {99865, 190651, 273542, 349526, 419431, 483959,
+                                                        543707, 599187, 650841, 699051, 744151, 786432,
+                                                        826151, 863534, 898780, 932068, 963557, 993388,
+                                                        1021690, 1048576, 1074152, 1098509, 1121733, 1143902,
+                                                        1165085, 1185347, 1204747, 1223339, 1241172, 1258292,
+                                                        1274740, 1290556, 1305774, 1320430, 1334552, 1348170,
+                                                        1361310, 1373997, 1386254, 1398102, 1409562, 1420652,
+                                                        1431390, 1441792, 1451875, 1461652, 1471137, 1480343,
+                                                        1489282, 1497966, 1506405, 1514610, 1522590, 1530355,
+                                                        1537912, 1545270, 1552438, 1559421, 1566228, 1572864,
+                                                        1579337, 1585652, 1591815, 1597831, 1603705, 1609443,
+                                                        1615049, 1620527, 1625882, 1631119, 1636240, 1641250,
+                                                        1646152, 1650950, 1655647, 1660246, 1664750, 1669162,
+                                                        1673485, 1677722, 1681875, 1685946, 1689939, 1693854,
+                                                        1697695, 1701463, 1705161, 1708791};
 // array holding the 10x the SWR measured at the various bands (0 == SWR was >3 at more than 1 run)
 uint8_t swr[BAND_COUNT];
 // sum of all SWR-values
@@ -165,8 +270,44 @@ uint16_t swr_sum = BAND_COUNT;
 const uint8_t SWR_AVG_LENGTH = 10;
 uint8_t swr_avg[SWR_AVG_LENGTH];
 uint8_t swr_avg_pointer;
+// running sum of the sliding average's values
+uint16_t swr_avg_sum;
+// number of snapshots in the EEPROM ring of the SWR statistics (saved hourly, so each slot is written every 3h)
+const uint8_t SWR_STATS_SLOTS = 3;
 // Flag indicating that the SWR-meater is active
 uint8_t SWR_check_active = 0;
+// the SWR-meter's linearisation table: number of supporting points (SWR_X/SWR_Y), the segment (index of its first
+// supporting point) each block of 16 ADC values starts in and the slopes [Q8] of all segments
+const uint8_t SWR_POINTS = sizeof(SWR_X)/sizeof(SWR_X[0]);
+const uint8_t SWR_BLOCKS = 64;
+uint8_t swr_block_start[SWR_BLOCKS];
+uint16_t swr_slope[SWR_POINTS-1];
+
+// the SWR-meter's ADC sampling: the ADC-isr alternates between the forward and the reflected channel (single
+// conversions restarted by the isr -> 1 pair per 208µs) and puts each complete pair into a ring buffer, where
+// the "check SWR" routine picks the newest one; the ADC is never awaited by the main loop
+struct swr_sample {
+  uint16_t fwd;
+  uint16_t ref;
+  uint32_t stamp; // micros() at the end of the pair
+};
+const uint8_t SWR_RING_SIZE = 4; // must be a power of 2
+volatile swr_sample swr_ring[SWR_RING_SIZE];
+// number of pairs completed (the newest one is at swr_ring[swr_sample_seq & (SWR_RING_SIZE-1)]) and the number
+// of the pair consumed last
+volatile uint8_t swr_sample_seq = 0;
+uint8_t swr_sample_consumed = 0;
+// ADMUX settings for both channels, the forward value waiting for its reflected counterpart and the flags
+// indicating the channel being converted and that sampling is active
+uint8_t adc_admux_fwd;
+uint8_t adc_admux_ref;
+volatile uint16_t adc_fwd;
+volatile uint8_t adc_ref_pending = 0;
+volatile uint8_t adc_sampling = 0;
+// fast trip: the ADC-isr checks every pair against SWR 3.0 and resets the DDS at once if it's exceeded (sampling
+// stops and the tripping pair remains the newest one in the ring); the flag is cleared by the "check SWR"
+// routine, which does the regular shutdown and the "swr"-bookkeeping
+volatile uint8_t swr_tripped = 0;
 
 // the "band switch"
 uint8_t band_pointer = BAND_COUNT - 1;
@@ -187,7 +328,7 @@ uint32_t deltaphase;
 
 // variables and constants used by the receiver
 
-const uint8_t BYTE_RATE = 30;
+const uint8_t BYTE_RATE = DR_AUTO_BAUD; // the receiver locks to the byte rate set at the GPS-module
 
 /*
   array of "dset_r" (defined in the DataReceiver library)
@@ -197,9 +338,14 @@ const uint8_t BYTE_RATE = 30;
     uint8_t ID; // the ID of the dataset
     uint8_t SIZE; // number of elements
     f_ptr FUNCTION; // a function to be called for data-processing
+    uint16_t delivered; // the number of datasets with this ID handed over valid
   }
 */
-dset_r dataset[2];
+dset_r dataset[4];
+// the number of datasets in use (those with forward error correction only if GPS_FEC is set)
+const uint8_t DATASET_COUNT = GPS_FEC ? 4 : 2;
+// the receive buffer (2 slots for the biggest dataset, as codewords if GPS_FEC is set)
+uint8_t rx_buffer[drBufferSize(2, drFrameSize(GPS_FEC ? FEC_FLAG : 0, GPS_DATASETS_MAX_SIZE))];
 
 // Variables/constants used by the repetitive task scheduler
 
@@ -209,13 +355,6 @@ dset_r dataset[2];
 // set to 100µs
 const uint8_t TLR = 100;
 
-// a constant specifying the loop cycles between 2 executions of the "process_datasets"-routine
-// cycles = interval-time[µs]/TLR
-// set to 4s
-const uint16_t PROCESS_DATASETS_LOOPS = 4000000/TLR;
-// the "process datasets" loop cycle counter
-uint16_t process_datasets_loop_counter = 0;
-
 // a constant specifying the loop cycles between 2 executions of the "system timer"-routine
 // cycles = interval-time[µs]/TLR
 // set to 100ms
@@ -248,30 +387,115 @@ int16_t transmit_symbol_loop_counter = TRANSMIT_SYMBOL_LOOPS;
 
 // a timer counting the seconds after system-startup; resolution is 0.1s (10 == 1s)
 volatile uint32_t timer = 0;
-// a constant holding the max. task-id (in this example 6 tasks from 0...5 are available)
-const uint8_t MID = 5;
+// a constant holding the max. task-id (in this example 9 tasks from 0...8 are available)
+const uint8_t MID = 8;
 // an array holding the due-time for all scheduled tasks (<0 == off/no execution)
 volatile int32_t tl[MID + 1];
 
+// Variables/constants used by the GPS 1PPS-input
+
+// the micros()-timestamp of the last rising PPS-edge and a flag indicating that it is valid (set by the isr, cleared
+// by the "system timer" once the edge is older than PPS_TIMEOUT, long before the timestamp wraps after 71.6 minutes)
+volatile uint32_t pps_timestamp;
+volatile uint8_t pps_valid = 0;
+// the maximum age [µs] of the last PPS-edge for the signal to be considered valid
+const uint32_t PPS_TIMEOUT = 1500000;
+// the input register and bit mask of the PPS-input (read directly by the isr)
+volatile uint8_t *pps_input;
+uint8_t pps_mask;
+// flag set by timer 1 when the first symbol of a PPS-aligned transmission is due
+volatile uint8_t pps_start = 0;
+// timer 1 is either the PPS one-shot timer or the receiver's input capture timer
+static_assert(!PPS_INSTALLED || GPS_INPUT_PIN != DR_ICP_PIN, "PPS_INSTALLED requires GPS_INPUT_PIN != DR_ICP_PIN");
+
+// Variables/constants used by the tickless idle mode
+
+// a wait-time [µs] which is guaranteed to be terminated by the next timer 0 overflow (every 1.024ms)
+// shorter waits are handled by busy-waiting
+const uint16_t IDLE_SLEEP_MARGIN = 1100;
+// flag set by interrupt routines raising an event (e.g. "dataset ready"), which ends a sleeping wait early
+volatile uint8_t wake_event = 0;
+
+// power-save mode: timer 2 (CTC mode, prescaler 1024 -> 64µs per tick) is the only clock running and wakes the MCU;
+// timer 0 stops, hence a sleep lasts whole timer 0 overflow periods (16 ticks), which are added to the Arduino core's
+// time keeping afterwards; at most 16 periods (16.4ms) per sleep
+const uint8_t PWR_SAVE_MAX_PERIODS = 16;
+extern volatile unsigned long timer0_overflow_count;
+extern volatile unsigned long timer0_millis;
+// flag set by the timer 2 compa-isr (the power-save sleep ended in time)
+volatile uint8_t pwr_save_timeout;
+// the fraction of a ms [1/125ms] added to timer0_millis in excess of whole ms (the core keeps its own)
+uint8_t pwr_save_fract = 0;
+
+// the receiver can't detect edges in power-save mode; the GPS-module transmits its datasets periodically, hence the
+// MCU only sleeps in power-save mode within the shortest time between two datasets observed (minus a guard time)
+// after the last dataset [ms]
+const uint16_t RX_GUARD = 1000;
+volatile uint32_t rx_last = 0;
+volatile uint32_t rx_min_gap = 0;
+
+// rough supply current [µA] of the ATmega328P @16MHz/5V while active, in idle mode (datasheet figures) and in
+// power-save mode with the crystal oscillator running for timer 2 (not specified in the datasheet, estimate)
+const uint16_t ACTIVE_CURRENT = 9500;
+const uint16_t IDLE_CURRENT = 2800;
+const uint16_t PWR_SAVE_CURRENT = 600;
+
+// a time account (s and remaining µs; the µs are folded into seconds by subtraction, so adding needs no division)
+struct time_acc {
+  uint32_t s;
+  uint32_t us;
+};
+
+// the time the loop spent sleeping (in total and in power-save mode) and busy-waiting and the millis()-timestamp
+// accounting was started at (only kept with DIAGNOSTICS on, for the power report)
+time_acc sleep_time = {0, 0};
+time_acc pwr_save_time = {0, 0};
+time_acc spin_time = {0, 0};
+uint32_t accounting_start = 0;
+
+// Variables/constants used by the scheduler instrumentation
+
+// probe-ids of the instrumented code sections (the tasks of the single task scheduler use their task-id)
+const uint8_t PROBE_SYMBOL = MID + 1;
+const uint8_t PROBE_SWR = MID + 2;
+const uint8_t PROBE_LCD = MID + 3;
+const uint8_t PROBE_COUNT = MID + 4;
+const char PROBE_NAMES[PROBE_COUNT - MID - 1][7] PROGMEM = {"symbol", "SWR", "LCD"};
+
+// execution time statistics [µs] of an instrumented code section
+struct exec_stats {
+  uint16_t max;
+  uint16_t count;
+  uint32_t sum;
+};
+exec_stats probe_stats[PROBE_COUNT];
+
+// loop runtime histogram; bucket i counts the loops with a runtime below TLR*2^(i-2), the last one all others
+// (i.e. buckets 3 and up are overruns)
+const uint8_t LOOP_HIST_SIZE = 8;
+uint16_t loop_hist[LOOP_HIST_SIZE];
+// the number of times the runtime budget has been reset due to constant overruns
+uint16_t budget_resets = 0;
+
 //##########################################################################################################
 //##########################################################################################################
 
 // dataset 0 is available -> process data
-// keep processing short; no new data will be received while this one is busy!!!
+// keep processing short; meanwhile further datasets are received into the other slots only
 void processDataset_0() {
 
-  uint8_t *data = DR.getDataArray();
+  const gps_dataset *gps = DR.getDataset<gps_dataset>();
 
-  uint8_t shift;
-  for(uint8_t i=0; i<2; ++i) {
-    shift = i<<2;
-    for(uint8_t j=0; j<3; ++j) {
-      lat_long[j][i] = *(data + j + shift);
-    }
-    lat_long[3][i] = char(*(data + 3 + shift));
-  }
+  lat_long[0][0] = gps->lat_deg;
+  lat_long[1][0] = gps->lat_min;
+  lat_long[2][0] = gps->lat_sec;
+  lat_long[3][0] = gps->lat_o;
+  lat_long[0][1] = gps->long_deg;
+  lat_long[1][1] = gps->long_min;
+  lat_long[2][1] = gps->long_sec;
+  lat_long[3][1] = gps->long_o;
 
-  sog = *(data+10);
+  sog = gps->sog;
   if(SPEED_UNIT) {
     uint32_t s = sog;
     if(SPEED_UNIT & 1) { // mph instead of km/h
@@ -283,7 +507,7 @@ void processDataset_0() {
     sog = s/1000000;
   }
 
-  DR.dataTransfer(&alt, 2, 8, 0);
+  alt = gps->alt;
   if(DIST_UNIT) { // feet instead of meter
     uint32_t a = alt;
     a *= 328084;
@@ -291,16 +515,17 @@ void processDataset_0() {
   }
 
   // read outside temperature from received datastream
-  DR.dataTransfer(&temp, 2, 19, 0);
-  temp = (temp+8)/16;
+  temp = (gps->temp+8)/16;
   if(TEMP_SCALE) { temp = (9*temp + 160)/5; }
+  touchSource(SRC_TEMP);
 
   // read QTH-locator from received datastream
-  DR.dataTransfer(locator, 4, 12, 0);
-  DR.dataTransfer(loc, 2, 16, 0);
+  memcpy(locator, gps->locator, 4);
+  memcpy(loc, gps->locator + 4, 2);
+  touchSource(SRC_GPS);
   
   // read GPS-time from received datastream
-  DR.dataTransfer(&gps_time, 4, 21, 0);
+  gps_time = gps->utc;
   uint8_t d_s;
   // calculate time [ms] since dataset was received
   int32_t d_ms = millis() - DR.getTimestamp();
@@ -315,16 +540,35 @@ void processDataset_0() {
 //###########################################################################################################
 
 // dataset 1 is available -> process data
-// keep processing short; no new data will be received while this one is busy!!!
+// keep processing short; meanwhile further datasets are received into the other slots only
 void processDataset_1() {
+  const astro_dataset *astro = DR.getDataset<astro_dataset>();
+
   // read speed over ground from received datastream
-  DR.dataTransfer(&sog, 1, 0, 0);
+  sog = astro->sog;
 
   // read Sun's and Moon's rise/set-times from received datastream
-  DR.dataTransfer(rs, 16, 1, 0);
+  for(uint8_t i=0; i<4; ++i) {
+    rs[i] = astro->rise_set[i];
+  }
 
   // read Moon's phase from received datastream
-  DR.dataTransfer(&phase, 2, 33, 0);
+  phase = astro->moon_phase;
+
+  touchSource(SRC_GPS);
+  touchSource(SRC_ASTRO);
+}
+
+//###########################################################################################################
+
+// "dataset ready"-event (called by the DataReceiver-isr) -> process the dataset with the next scheduler run
+void datasetReady() {
+  scheduleTask(8, 0);
+  wake_event = 1;
+
+  uint32_t t = millis();
+  if(rx_last && (!rx_min_gap || t - rx_last < rx_min_gap)) { rx_min_gap = t - rx_last; }
+  rx_last = t;
 }
 
 //##########################################################################################################
@@ -335,6 +579,10 @@ void setup() {
   analogReference(ref);
   pinMode(SWR_FWD_PIN, INPUT);
   pinMode(SWR_REF_PIN, INPUT);
+// prepare the interrupt-driven SWR sampling (the ADC has been enabled with prescaler 128 by the core)
+  adc_admux_fwd = (ref << 6) | ((SWR_FWD_PIN - A0) & 0x0F);
+  adc_admux_ref = (ref << 6) | ((SWR_REF_PIN - A0) & 0x0F);
+  if(SWR_METER_INSTALLED) { ADCSRA |= (1 << ADIE); } // enable ADC conversion complete interrupt
 
   pinMode(TRANSMITTER_DISABLED_PIN, INPUT);  
 
@@ -365,46 +613,48 @@ void setup() {
   digitalWrite(LED, HIGH);
 // Display intro   
   writeToBuffer(INTRO);
-  loadLCD();
+  flushLCD();
   delay(2000);
 
-/*
-initializes the CRC library
-
-Parameter:
- - the EEPROM start address to store the 256 byte CRC lookup table
-
- returns the next free address in EEPROM
-*/
-  uint16_t eeprom_address = 0;
-  eeprom_address = CRC.init(eeprom_address);
+// the first 256 byte of EEPROM held the CRC lookup table of former versions (the CRC8 library keeps it in
+// flash); they are left unused, so that stored settings remain valid
+  uint16_t eeprom_address = 256;
 
 // create datasets
-  dataset[0] = DR.createDataset(0, 25, processDataset_0);
-  dataset[1] = DR.createDataset(1, 35, processDataset_1);
+  dataset[0] = DR.createDataset<gps_dataset>(GPS_DATASET_ID, processDataset_0);
+  dataset[1] = DR.createDataset<astro_dataset>(ASTRO_DATASET_ID, processDataset_1);
+// the same datasets sent with forward error correction (only used if GPS_FEC is set)
+  dataset[2] = DR.createDataset<gps_dataset>(GPS_DATASET_ID | FEC_FLAG, processDataset_0);
+  dataset[3] = DR.createDataset<astro_dataset>(ASTRO_DATASET_ID | FEC_FLAG, processDataset_1);
 
 /*
 initializes the DataReceiver
 
 Parameter DataReceiver (f.l.t.r.):
-"BYTE_RATE" -> the data transfer rate set at the transmitter in Byte/s
+"BYTE_RATE" -> the data transfer rate set at the transmitter in Byte/s (DR_AUTO_BAUD -> detected automatically)
 "GPS_INPUT_PIN" -> the digital, interrupt-capable pin the receiver is connected to
 "d_set" -> array of "dset", holding all dataset-relevant information
 "DATASET_COUNT" -> the number of datasets (size of DATASET)
+"rx_buffer" -> the receive buffer (statically allocated) and its size
 */
-  DR.init(BYTE_RATE, GPS_INPUT_PIN, dataset, 2);
+  DR.init(BYTE_RATE, GPS_INPUT_PIN, dataset, DATASET_COUNT, rx_buffer, sizeof(rx_buffer));
+  DR.onDatasetReady(datasetReady);
 
 // read beacon's band status and duty-cycle from EEPROM
   for(uint8_t i=0; i<BAND_COUNT; ++i) {
     band_status[i] = EEPROM.read(eeprom_address + i);
   }
   beacon_idle_level = min(EEPROM.read(eeprom_address + BAND_COUNT), 19);
+
+// load the SWR statistics (stored behind band status and duty-cycle; "eeprom_address" is still needed by the
+// setup-dialog below)
+  SWRStats.init(eeprom_address + BAND_COUNT + 1, SWR_STATS_SLOTS);
     
 // Check status of "disable transmitter" switch and if it's set to "off" start setup-dialog
   if(digitalRead(TRANSMITTER_DISABLED_PIN)) {
     Serial.begin(9600);
     writeToBuffer(SERIAL_DISP);
-    loadLCD();
+    flushLCD();
     do {
       Serial.println(F("\n\nWSPR beacon setup dialog.\n"));
 
@@ -478,29 +728,46 @@ Parameter DataReceiver (f.l.t.r.):
     }
     min_one_band_active += band_status[i];
   }
-  loadLCD();
+  flushLCD();
   delay(2000);
 
 // test-code WSPR message & check band status (at least 1 must be active)
 // in case of errors system will be halted
   if(!WSPR.encodeMessage(CALL, locator, POWER) || !min_one_band_active) {
     writeToBuffer(SETTINGS_NOT_VALID);
-    loadLCD();
+    flushLCD();
     endlessLoop();
   }
 
+// build the SWR-meter's linearisation table
+  if(SWR_METER_INSTALLED) { initSWRTable(); }
+
 // Initially calculate and set the delta-phase values for WSPR lower band limits @ 160-10m
   for(uint8_t i=0; i<BAND_COUNT; i++) {
     deltaphase_base[i] = dds.calculatePhaseValue(pgm_read_dword_near(BASE_FREQUENCY + i));
   }
 
-// initialize timer 2
+// initialize timer 2 (backlight PWM)
+  led_port = portOutputRegister(digitalPinToPort(LED));
+  led_mask = digitalPinToBitMask(LED);
   cli(); // disable global interrupts
-  TCCR2A = 0; // set entire TCCR2A register to 0
-  TCCR2B = 0; // set entire TCCR2B register to 0
-  OCR2A = 59; // set compare match register to trigger every 30µs
-  TCCR2A |= (1 << WGM21);  // turn on CTC mode
-  TIMSK2 |= (1 << OCIE2A); // enable timer compare interrupt
+  TCCR2A = (1 << WGM21) | (1 << WGM20); // turn on fast PWM mode (TOP = 0xFF)
+  TCCR2B = 0; // set entire TCCR2B register to 0 (timer stopped)
+  TIMSK2 = (1 << TOIE2); // enable timer overflow interrupt
+  if(!LED_HARDWARE_PWM) { TIMSK2 |= (1 << OCIE2B); } // enable timer compare interrupt (switches the LED off)
+
+// initialize the 1PPS-input (pin change interrupt) and timer 1 (one-shot timer starting the transmission)
+  if(PPS_INSTALLED) {
+    pinMode(PPS_PIN, INPUT);
+    pps_input = portInputRegister(digitalPinToPort(PPS_PIN));
+    pps_mask = digitalPinToBitMask(PPS_PIN);
+    *digitalPinToPCMSK(PPS_PIN) |= (1 << digitalPinToPCMSKbit(PPS_PIN));
+    *digitalPinToPCICR(PPS_PIN) |= (1 << digitalPinToPCICRbit(PPS_PIN));
+
+    TCCR1A = 0; // set entire TCCR1A register to 0
+    TCCR1B = 0; // set entire TCCR1B register to 0 (timer stopped)
+    TIMSK1 = (1 << OCIE1A); // enable timer compare interrupt
+  }
   sei(); // enable global interrupts
 
   setPhaseValue(0, 0);
@@ -510,33 +777,105 @@ Parameter DataReceiver (f.l.t.r.):
 
 // call randomSeed()  
   scheduleTask(1, 0);
+
+// start refreshing the display fields
+  scheduleTask(2, 0);
+
+// start saving the SWR statistics
+  if(SWR_METER_INSTALLED) { scheduleTask(7, 36000); }
+
+// start serial diagnostics
+  if(DIAGNOSTICS) {
+    Serial.begin(9600);
+    scheduleTask(6, 0);
+  }
+  accounting_start = millis();
  
 }
 
 //##########################################################################################################
 //##########################################################################################################
 
-// timer 2 compa-isr (backlight pulsing)
-ISR(TIMER2_COMPA_vect) {
-  if(!backlight_on_time_counter) {
-    digitalWrite(LED, 1);
+// ADC conversion complete-isr (SWR-meter sampling / forward and reflected channel alternating)
+ISR(ADC_vect) {
+  uint16_t value = ADC;
+
+  if(!adc_ref_pending) {
+    adc_fwd = value;
+    ADMUX = adc_admux_ref;
+    adc_ref_pending = 1;
+  }
+  else {
+    uint8_t seq = swr_sample_seq + 1;
+    volatile swr_sample *slot = swr_ring + (seq & (SWR_RING_SIZE-1));
+    slot->fwd = adc_fwd;
+    slot->ref = value;
+    slot->stamp = micros();
+    swr_sample_seq = seq;
+
+  // same criterion as the "check SWR" routine (SWR*10 >= 31 <=> ref<<16 >= SWR_THRESHOLD[31-11]*fwd)
+    if(adc_fwd > 255 && !swr_tripped && (uint32_t(getSWRValue(value))<<16) >=
+       pgm_read_dword_near(SWR_THRESHOLD + 31 - 11) * adc_fwd) {
+      dds.emergencyStop();
+      swr_tripped = 1;
+      adc_sampling = 0;
+    }
 
-    if(brightness==255) { brightness_change = -1; }
+    ADMUX = adc_admux_fwd;
+    adc_ref_pending = 0;
+  }
+
+  if(adc_sampling) { ADCSRA |= (1 << ADSC); }
+}
+
+// timer 2 overflow-isr (backlight pulsing / start of a PWM period)
+ISR(TIMER2_OVF_vect) {
+  if(!LED_HARDWARE_PWM) { *led_port |= led_mask; }
+
+  if(++backlight_period_counter == BACKLIGHT_STEP_PERIODS) {
+    backlight_period_counter = 0;
+
+    if(brightness_step == BACKLIGHT_STEPS - 1) { brightness_change = -1; }
     else {
-      if(brightness==MIN_BRIGHTNESS) {
+      if(!brightness_step) {
         brightness_change = 1;
         scheduleTask(5, 0);
       }
     }
 
-    brightness+=brightness_change;
+    brightness_step += brightness_change;
+    OCR2B = pgm_read_byte_near(BACKLIGHT_GAMMA + brightness_step); // takes effect with the next period
   }
-  else {
-    if(backlight_on_time_counter == brightness) { digitalWrite(LED, 0); }
+}
+
+// timer 2 compb-isr (backlight pulsing / end of the on-time; not used with hardware PWM)
+ISR(TIMER2_COMPB_vect) {
+  *led_port &= ~led_mask;
+}
+
+// timer 2 compa-isr (end of a power-save sleep)
+ISR(TIMER2_COMPA_vect) {
+  pwr_save_timeout = 1;
+}
+
+#if PPS_INSTALLED
+// pin change-isr (GPS 1PPS-input / port C)
+ISR(PCINT1_vect) {
+  if(*pps_input & pps_mask) {
+    pps_timestamp = micros();
+    pps_valid = 1;
   }
-  backlight_on_time_counter++;
 }
 
+//##########################################################################################################
+
+// timer 1 compa-isr (first symbol of a PPS-aligned transmission is due)
+ISR(TIMER1_COMPA_vect) {
+  TCCR1B = 0; // stop timer 1
+  pps_start = 1;
+}
+#endif
+
 //##########################################################################################################
 //##########################################################################################################
 
@@ -549,23 +888,19 @@ void loop() {
 
   const int32_t MIN_DT = LONG_MIN>>1;
 
-// trigger "process datasets" execution (runs every second)
-  if(process_datasets_loop_counter == PROCESS_DATASETS_LOOPS) {
-
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { // this makes sure the following block of code will not get interrupted 
-      if(DR.getStatus()&4 && DR.validateData()) {//check if data is available and consistent and if so ...
-        DR.setStatus(2); // ... mark dataset as "busy reading" and ...
-        (dataset + DR.getPos())->FUNCTION(); //... process it by calling its function
-        DR.setStatus(0); // release dataset to enable reception of next transmission
-      }
-    }
+  uint32_t loop_start = probeStart();
 
-    // task has been executed -> set counter to 0
-    process_datasets_loop_counter = 0;
+// start a PPS-aligned transmission (first symbol now, SWR-readout 2.3ms later)
+  if(pps_start) {
+    pps_start = 0;
+    transmit_symbol_loop_counter = TRANSMIT_SYMBOL_LOOPS;
+    check_SWR_loop_counter = 0;
   }
 
 // trigger "transmit symbol" execution (runs every 683ms)
   if(transmit_symbol_loop_counter == TRANSMIT_SYMBOL_LOOPS) {
+    uint32_t probe = probeStart();
+
     if(on_air) {
       // terminate transmission after 110.6s
       if(symbol_counter == 162) {
@@ -577,42 +912,51 @@ void loop() {
       }
     }
 
+    probeStop(PROBE_SYMBOL, probe);
     transmit_symbol_loop_counter = 0;
   }
 
 // trigger "system timer" execution (runs every 100ms)
   if(system_timer_loop_counter == SYSTEM_TIMER_LOOPS) {
     timer++;   
+    if(PPS_INSTALLED) { checkPPSTimeout(); }
     system_timer_loop_counter = 0;
   }
 
 // trigger "check SWR" execution (runs every 2.3ms)
   if(check_SWR_loop_counter == CHECK_SWR_LOOPS) {
   // readout SWR-meter and check SWR to be <= 3.0
-    if(SWR_check_active) {
+    uint32_t probe = probeStart();
+
+    swr_sample sample;
+    // after a fast trip the DDS is already off; the tripping pair still has to be processed
+    if((SWR_check_active || swr_tripped) && getSWRSample(&sample)) {
     // wait until forward reading has reached 25% of max-value to avoid false triggering
-      fwd_value = analogRead(SWR_FWD_PIN);
+      fwd_value = sample.fwd;
       if(fwd_value > 255) {
-        ref_value = getPolyValue(analogRead(SWR_REF_PIN), 18, SWR_X, SWR_Y);
-        ref_value <<= 16;
-        ref_value /= fwd_value;
-        if(ref_value > 1712353) { ref_value = 1712353; }
-        // store current swr-value in swr-averaging array
-        swr_avg[swr_avg_pointer] = (20971520 + 10*ref_value)/(2097152 - ref_value);
+        uint8_t swr_value = getSWR(getSWRValue(sample.ref), fwd_value);
+        SWRStats.record(band_pointer, swr_value);
 
-        if(swr_avg[swr_avg_pointer] > 30) {
+        if(swr_value > 30) {
+          swr_tripped = 0;
           setPhaseValue(0, 0);
           if(swr[band_pointer] > 30) {
-            swr_avg[swr_avg_pointer] = 0;
+            swr_value = 0;
           }
-          swr[band_pointer] = swr_avg[swr_avg_pointer];
+          swr[band_pointer] = swr_value;
         }
 
+        // store current swr-value in swr-averaging array
+        swr_avg_sum += swr_value - swr_avg[swr_avg_pointer];
+        swr_avg[swr_avg_pointer] = swr_value;
+        touchSource(SRC_SWR);
+
         // increase swr-average array pointer
         swr_avg_pointer = (swr_avg_pointer == (SWR_AVG_LENGTH - 1)) ? 0 : swr_avg_pointer + 1;
       }
     }
-  
+
+    probeStop(PROBE_SWR, probe);
     check_SWR_loop_counter = 0;
   }
 
@@ -627,6 +971,8 @@ until stopped externally by "scheduleTask(id, -1)"
     for(uint8_t i=0; i<=MID; i++) {
       if(tl[i] > -1 && tl[i] <= timer) {
         tl[i] = -1;
+
+        uint32_t probe = probeStart();
           
         switch(i) {
 // execute task 0 -> switching of transmitter
@@ -658,15 +1004,22 @@ until stopped externally by "scheduleTask(id, -1)"
               if(!on_air && !second() && !(minute()%2) && swr_sum && gps_valid) {
 				        // Check that the duty cycle is being met
 				        if(!beacon_idle_counter) {
-                  // delay transmission by 950ms (should actually start 1s into the even minute)
-                  transmit_symbol_loop_counter = -267333/TLR;
+                  // start transmission 1s into the even minute, aligned to the GPS 1PPS-signal if available
+                  uint8_t pps_aligned = armPPSStart();
+                  if(!pps_aligned) {
+                    // delay transmission by 950ms (should actually start 1s into the even minute)
+                    transmit_symbol_loop_counter = -267333/TLR;
+                  }
 
                   // schedule SWR-readout to start 2.3ms after the beacon
                   if(SWR_METER_INSTALLED) {
-                    check_SWR_loop_counter = -949800/TLR;
+                    check_SWR_loop_counter = pps_aligned ? INT16_MIN : -949800/TLR;
                     SWR_check_active = 1;
+                    startSWRSampling();
                     initArray(swr_avg, SWR_AVG_LENGTH, 10);
+                    swr_avg_sum = 10*SWR_AVG_LENGTH;
                     swr_avg_pointer = 0; 
+                    touchSource(SRC_SWR);
                   }
                 
                   // check if band is activated and SWR was ok during previous run
@@ -681,6 +1034,7 @@ until stopped externally by "scheduleTask(id, -1)"
                   for(uint8_t i=0; i<3; i++) {
                     band[i] = pgm_read_byte_near(BAND_INFO + 3*band_pointer + offset + i);
                   }
+                  touchSource(SRC_BAND);
 
                   deltaphase = deltaphase_base[band_pointer];
                   if(beacon_mode) {
@@ -710,49 +1064,23 @@ until stopped externally by "scheduleTask(id, -1)"
             randomSeed(now());
             scheduleTask(1, 36000); // Re-schedule in 1h
           break;
-// execute task 2 -> update those display items that require high-frequency refreshing
+// execute task 2 -> update those fields of the active screen whose data has changed (e.g. time & date)
           case 2:
-            switch(fast_refresh_pointer) {
-              // refresh time & date
-              case 0:
-                static time_t ts_last = 0;
-                time_t ts;
-                ts = now();
-                if(ts!=ts_last) {
-                  ts_last = ts;
-
-                  writeNumber(hour(ts), -3, 1, 2);
-                  writeNumber(minute(ts), 0, 1, 2);
-                  writeNumber(second(ts), 3, 1, 2);
-
-                  uint8_t wd = 3*(weekday(ts)-1);
-                  for(uint8_t i=0; i<3; i++) {
-                    lcd_content[i + 16] = pgm_read_byte_near(WEEKDAY_CODING + i + wd);
-                  }
-          
-                  writeNumber(day(ts), 18, 1, 2);
-                  writeNumber(month(ts), 21, 1, 2);
-                  writeNumber(year(ts), 26, 1, 4);
-
-                  loadLCD();
-                }
-              break;
-              // calculate and display average SWR
-              case 1:
-                // calculate swr-average
-                static uint16_t swr_average;
-                swr_average = 0;
-                for(uint8_t i=0; i<SWR_AVG_LENGTH; i++) {
-                  swr_average += swr_avg[i];
-                }
-                swr_average /= SWR_AVG_LENGTH;
-
-                lcd_content[27] = '0'+swr_average/10;
-                lcd_content[29] = '0'+swr_average%10;
-
-                loadLCD();
-                break;        
+            static time_t ts_last = 0;
+            time_t ts;
+            ts = now();
+            if(ts != ts_last) {
+              // the rise/set times are displayed as "today" or with their date (compares the whole date, so a
+              // jump of the clock to the same day of another month or year is noticed as well)
+              if(elapsedDays(ts) != elapsedDays(ts_last)) {
+                touchSource(SRC_DATE);
+                touchSource(SRC_ASTRO);
+              }
+              ts_last = ts;
+              touchSource(SRC_CLOCK);
             }
+
+            if(active_screen != NO_SCREEN && renderScreen(active_screen)) { loadLCD(); }
             
             scheduleTask(2, 1); // Re-schedule in 100ms
           break;
@@ -771,7 +1099,48 @@ until stopped externally by "scheduleTask(id, -1)"
           case 5:
             if(disp_content_pointer <= MAX_DISP_CONTENT) { setDisplayContent(); }
           break;
+// execute task 6 -> serial diagnostics (answer requests received via the serial interface)
+          case 6:
+            scheduleTask(6, 1); // Re-schedule in 100ms
+            switch(Serial.read()) {
+              case 'p':
+              case 'P':
+                printPowerReport();
+              break;
+              case 's':
+              case 'S':
+                if(SCHEDULER_STATS) { printSchedulerStats(); }
+              break;
+              case 'r':
+              case 'R':
+                if(SCHEDULER_STATS) { resetSchedulerStats(); }
+                DR.resetStats();
+              break;
+              case 'l':
+              case 'L':
+                printLinkStats();
+              break;
+              case 'w':
+              case 'W':
+                if(SWR_METER_INSTALLED) { SWRStats.dump(Serial); }
+              break;
+            }
+          break;
+// execute task 7 -> save the SWR statistics to EEPROM (byte by byte, while not transmitting)
+          case 7:
+            if(on_air) { scheduleTask(7, 100); } // retry in 10s
+            else {
+              if(SWRStats.save()) { scheduleTask(7, 36000); } // Re-schedule in 1h
+              else { scheduleTask(7, 0); }
+            }
+          break;
+// execute task 8 -> process the received datasets (scheduled by the DataReceiver's "dataset ready"-event)
+          case 8:
+            DR.dispatch();
+          break;
         }
+
+        probeStop(i, probe);
       }
     }
     
@@ -779,12 +1148,20 @@ until stopped externally by "scheduleTask(id, -1)"
   }
   
 // increment all loop counters
-  ++process_datasets_loop_counter;
   transmit_symbol_loop_counter++;
   system_timer_loop_counter++;
   single_task_scheduler_loop_counter++;
   check_SWR_loop_counter++;
 
+// transfer pending LCD changes (lowest priority: only if the loop is on time and neither the next symbol
+// nor the SWR readout is due within the next loop cycle)
+  if(lcd_refresh_pending && dt >= 0 && transmit_symbol_loop_counter != TRANSMIT_SYMBOL_LOOPS
+                                    && check_SWR_loop_counter != CHECK_SWR_LOOPS) {
+    serviceLCD(LCD_TRANSACTIONS);
+  }
+
+  recordLoopTime(loop_start);
+
 // loop delay handling
 // insures that on average the desired loop runtime will be met
 // delays due to code execution (e.g. when processing scheduled tasks) will be taken into account
@@ -798,13 +1175,31 @@ until stopped externally by "scheduleTask(id, -1)"
   
 // if runtime-budget is larger then target, insert delay-step
   if(dt > TLR) {
-    delayMicroseconds(dt);
-    stp += dt;
-    dt = 0;
+    if(TICKLESS_IDLE) {
+      // skip all loop cycles without due tasks and sleep until the next deadline or an event; after an early
+      // wake-up only the loop cycles actually passed are skipped (the rest of the budget is kept in "dt")
+      wake_event = 0;
+      uint16_t skip = getIdleLoops();
+      uint32_t waited = idleWait(dt + int32_t(skip)*TLR);
+      if(waited < uint32_t(dt)) { skip = 0; }
+      else { skip = min(uint32_t(skip), (waited - dt)/TLR); }
+      advanceLoopCounters(skip);
+      dt += int32_t(skip)*TLR - int32_t(waited);
+      stp += waited;
+    }
+    else {
+      delayMicroseconds(dt);
+      if(DIAGNOSTICS) { addTime(&spin_time, dt); }
+      stp += dt;
+      dt = 0;
+    }
   }
   else {
 // avoid overflow, in case the budget is constantly negative (loop is too slow to meet target loop time)
-    if(dt < MIN_DT) { dt = 0; }
+    if(dt < MIN_DT) {
+      dt = 0;
+      if(SCHEDULER_STATS && budget_resets < 0xFFFF) { budget_resets++; }
+    }
   }
 }
 
@@ -871,24 +1266,17 @@ uint8_t readYesNo() {
 
 //##########################################################################################################
 
-// support function / writes the Sun's and Moon's rise/set times in to the LCD-buffer
-void writeRiseSet(uint8_t is_moon) {
-	
-  uint8_t start = 0;
-  if(is_moon) start=2;
-
-  time_t r_s, ts = now();
-  for(uint8_t i=0; i<2; ++i) {
-    uint8_t shift = i<<4;
-    r_s = rs[start + i] + TIMEZONE*3600;
-    writeNumber(hour(r_s), 8 + shift, 1, 2);
-    writeNumber(minute(r_s), 11 + shift, 1, 2);
-	if(day(ts)!=day(r_s) || month(ts)!=month(r_s) || year(ts)!=year(r_s)) { // is "today" or not?
-	  lcd_content[7 + shift] = '.';
-	  lcd_content[10 + shift] = '.';
-      writeNumber(day(r_s), 2 + shift, 1, 2);
-      writeNumber(month(r_s), 5 + shift, 1, 2);
-    }
+// support function / writes a Sun's or Moon's rise/set time (index of "rs") into a line of the LCD-buffer
+// (shift 0 -> line 1; shift 16 -> line 2)
+void writeRiseSet(uint8_t index, uint8_t shift) {
+  time_t r_s = rs[index] + TIMEZONE*3600, ts = now();
+  writeNumber(hour(r_s), 8 + shift, 1, 2);
+  writeNumber(minute(r_s), 11 + shift, 1, 2);
+  if(day(ts)!=day(r_s) || month(ts)!=month(r_s) || year(ts)!=year(r_s)) { // is "today" or not?
+    lcd_content[7 + shift] = '.';
+    lcd_content[10 + shift] = '.';
+    writeNumber(day(r_s), 2 + shift, 1, 2);
+    writeNumber(month(r_s), 5 + shift, 1, 2);
   }
 }
 
@@ -903,34 +1291,50 @@ void initArray(uint8_t *target, uint8_t target_size, uint8_t value) {
 
 //##########################################################################################################
 
-// calculate and returns the corresponding y to a given x based on a linear polynomial fit / returns 0 if x
-// yields no result
-// "x" -> input value
-// "size" -> reference array size
-// array_x & array_y -> reference arrays
-
-uint16_t getPolyValue(const int16_t x, const uint16_t size, const uint16_t* array_x, const uint16_t* array_y) {
+// builds the SWR-meter's linearisation table from the supporting points SWR_X/SWR_Y (SWR_X must be ascending):
+// the segment each block of 16 ADC values starts in and the slope [Q8] of each segment
+void initSWRTable() {
+  uint8_t i = 0;
+  for(uint8_t b=0; b<SWR_BLOCKS; b++) {
+    while(i < SWR_POINTS-2 && (b<<4) > pgm_read_word_near(SWR_X + i + 1)) { i++; }
+    swr_block_start[b] = i;
+  }
 
-  uint16_t y = 0;
-  uint16_t xbegin, xend, ybegin, yend;
+  for(i=0; i<SWR_POINTS-1; i++) {
+    uint16_t dx = pgm_read_word_near(SWR_X + i + 1) - pgm_read_word_near(SWR_X + i);
+    uint32_t dy = pgm_read_word_near(SWR_Y + i + 1) - pgm_read_word_near(SWR_Y + i);
+    swr_slope[i] = ((dy<<8) + dx - 1)/dx; // rounded up
+  }
+}
 
-// search for the supporting points enclosing x and if found, calculate y
-  for(uint16_t i=0; i<size-1; i++) {
-  
-    xbegin = pgm_read_dword_near(array_x + i);
-    xend = pgm_read_dword_near(array_x + i + 1);
+//##########################################################################################################
 
-    if((xbegin<=xend && x>=xbegin && x<=xend) || (xbegin>xend && x<=xbegin && x>=xend)) {
+// returns the linearised value (times 32) for a given ADC reading (0...1023) of the SWR-meter by linear
+// interpolation between the supporting points SWR_X/SWR_Y; as the slopes are rounded up, the result exceeds the
+// exact (rounded down) value by less than (x - SWR_X[i])/256, i.e. by at most 1 LSB as long as no segment is wider
+// than 256 ADC values (tests/unit/SWR_test.cpp checks all readings)
+uint16_t getSWRValue(uint16_t x) {
+  uint8_t i = swr_block_start[x>>4];
+  // a block of 16 values may span several segments (only at the lower end of the curve)
+  while(i < SWR_POINTS-2 && x > pgm_read_word_near(SWR_X + i + 1)) { i++; }
 
-    ybegin = pgm_read_dword_near(array_y + i);
-    yend = pgm_read_dword_near(array_y + i + 1);
+  return pgm_read_word_near(SWR_Y + i) + ((uint32_t(swr_slope[i]) * (x - pgm_read_word_near(SWR_X + i)))>>8);
+}
 
-      y = ybegin + int32_t((yend-ybegin)*(x-xbegin))/(xend-xbegin);
-      break;
-    }
+// returns 10 times the SWR (10...98) for a linearised reflected value (times 32) and a forward ADC reading (1...1023)
+// the result equals (2^21*10 + 10*rho)/(2^21 - rho) with rho = (ref<<16)/fwd, but is found without any division by
+// a binary search comparing ref<<16 with SWR_THRESHOLD*fwd
+uint8_t getSWR(uint16_t ref, uint16_t fwd) {
+  uint32_t r = uint32_t(ref)<<16;
+  // the number of thresholds reached lies within [lo, hi]
+  uint8_t lo = 0, hi = SWR_THRESHOLDS;
+  while(lo < hi) {
+    uint8_t mid = (lo + hi + 1)>>1;
+    if(r >= pgm_read_dword_near(SWR_THRESHOLD + mid - 1) * fwd) { lo = mid; }
+    else { hi = mid - 1; }
   }
 
-  return y;
+  return 10 + lo;
 }
 
 //##########################################################################################################
@@ -944,10 +1348,12 @@ void backlightPulsingOn(uint8_t pulsing) {
       // initialize timer 2
       scheduleTask(4, -1);
       ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
-        brightness = 255;
-        backlight_on_time_counter = 0;
+        brightness_step = BACKLIGHT_STEPS - 1;
+        backlight_period_counter = 0;
+        OCR2B = pgm_read_byte_near(BACKLIGHT_GAMMA + brightness_step);
+        if(LED_HARDWARE_PWM) { TCCR2A |= (1 << COM2B1); } // connect OC2B (non-inverting PWM)
         TCNT2  = 0; //initialize counter value to 0
-        TCCR2B = 0b00000010; // prescaler 8
+        TCCR2B = (1 << CS22); // prescaler 64
       }
 
       pulsing_on = 1;
@@ -958,6 +1364,7 @@ void backlightPulsingOn(uint8_t pulsing) {
       // disable timer 2
       scheduleTask(4, 35);
       TCCR2B = 0; // set entire TCCR2B register to 0
+      TCCR2A &= ~(1 << COM2B1); // disconnect OC2B
       
       digitalWrite(LED, 1);
       pulsing_on = 0;
@@ -969,52 +1376,253 @@ void backlightPulsingOn(uint8_t pulsing) {
 // functions used for HD44780 control
 //##########################################################################################################
 
-// Sets the display content and updates the LCD; if short cycle updating is needed, a rapid update task will
-// be started automatically
-void setDisplayContent() {
+// screen field formatters / each one formats its data into the LCD buffer at the field's position "pos" (the
+// field's cells have been restored from the template before); numbers are right-aligned within the field
 
-// unschedule rapid updates  
-  scheduleTask(2, -1);
+void writeBand(uint8_t pos, uint8_t width) {
+  writeCharArray(band, pos, 3);
+}
 
-// clear display buffer
-  initArray(lcd_content, DISPLAY_SIZE, 32);
+void writeSWR(uint8_t pos, uint8_t width) {
+  if(SWR_METER_INSTALLED) {
+    char text[3];
+    NF.formatTenths(swr_avg_sum/SWR_AVG_LENGTH, text);
+    writeCharArray(text, pos, 3);
+  }
+}
+
+void writeCall(uint8_t pos, uint8_t width) {
+  writeCharArray(CALL, pos, 6);
+}
+
+void writeLocator(uint8_t pos, uint8_t width) {
+  writeCharArray(locator, pos, 4);
+  writeCharArray(loc, pos + 5, 2);
+}
+
+void writePower(uint8_t pos, uint8_t width) {
+  writeNumber(POWER, pos + width - 5, 0, 4);
+}
+
+void writeTime(uint8_t pos, uint8_t width) {
+  time_t ts = now();
+  writeNumber(hour(ts), pos - 3, 1, 2);
+  writeNumber(minute(ts), pos, 1, 2);
+  writeNumber(second(ts), pos + 3, 1, 2);
+}
+
+void writeDate(uint8_t pos, uint8_t width) {
+  time_t ts = now();
+  uint8_t wd = 3*(weekday(ts)-1);
+  for(uint8_t i=0; i<3; i++) {
+    lcd_content[pos + i] = pgm_read_byte_near(WEEKDAY_CODING + i + wd);
+  }
+  writeNumber(day(ts), pos + 2, 1, 2);
+  writeNumber(month(ts), pos + 5, 1, 2);
+  writeNumber(year(ts), pos + 10, 1, 4);
+}
+
+void writeTemp(uint8_t pos, uint8_t width) {
+  writeNumber(temp, pos + width - 5, 0, 3);
+}
+
+void writeTempUnit(uint8_t pos, uint8_t width) {
+  if(TEMP_SCALE) { lcd_content[pos] = 'F'; }
+}
+
+// the field's position determines the value (line -> latitude/longitude; column -> degree/minute/second)
+void writeLatLong(uint8_t pos, uint8_t width) {
+  writeNumber(lat_long[(pos & 15)>>2][pos>>4], pos + width - 5, 1, 2);
+}
+
+void writeHemisphere(uint8_t pos, uint8_t width) {
+  lcd_content[pos] = lat_long[3][pos>>4];
+}
+
+void writeAlt(uint8_t pos, uint8_t width) {
+  writeNumber(alt, pos + width - 5, 0, 4);
+}
+
+void writeDistUnit(uint8_t pos, uint8_t width) {
+  if(DIST_UNIT) { // feet instead of meter
+    char ft[3] = "ft";
+    writeCharArray(ft, pos, 2);
+  }
+}
+
+void writeSpeed(uint8_t pos, uint8_t width) {
+  writeNumber(sog, pos + width - 5, 0, 3);
+}
+
+void writeSpeedUnit(uint8_t pos, uint8_t width) {
+  if(SPEED_UNIT) {
+    lcd_content[pos + 2] = 32;
+    lcd_content[pos + 3] = 32;
+    if(SPEED_UNIT & 1) { // mph instead of km/h
+      char mph[4] = "mph";
+      writeCharArray(mph, pos, 3);
+    }
+    else { // knots instead of km/h
+      lcd_content[pos + 1] = 'n';
+    }
+  }
+}
+
+// the field's line determines rise (line 1) or set time (line 2)
+void writeSunRiseSet(uint8_t pos, uint8_t width) {
+  writeRiseSet(pos>>4, pos & 16);
+}
+
+void writeMoonRiseSet(uint8_t pos, uint8_t width) {
+  writeRiseSet(2 + (pos>>4), pos & 16);
+}
+
+void writeMoonPhase(uint8_t pos, uint8_t width) {
+  writeNumber((abs(phase)+50)/100, pos + width - 5, 0, 3);
+}
+
+void writeMoonTrend(uint8_t pos, uint8_t width) {
+  if(phase > 0) {
+    char in[3] = "in";
+    writeCharArray(in, pos, 2);
+  }
+}
+
+// the field's position determines the counter (line 1 -> preambles/datasets delivered; line 2 -> bit errors
+// corrected by the FEC/CRC errors; the timing violations are printed by the serial diagnostics); values above 9999
+// are displayed as 9999
+void writeLinkStats(uint8_t pos, uint8_t width) {
+  dr_stats st;
+  DR.getStats(&st);
+  uint16_t value;
+  switch(pos) {
+    case 3: value = st.preambles; break;
+    case 12: value = st.delivered; break;
+    case 19: value = st.fec_corrections; break;
+    default: value = st.crc_errors; break;
+  }
+  writeNumber(min(value, 9999), pos + width - 5, 0, 4);
+}
+
+//##########################################################################################################
+
+// the screen fields {position, width, source, formatter} and the screens {template, fields, field count}
+// the order of SCREENS must match the screen ids (SCREEN_STANDBY ... SCREEN_LINK)
+const screen_field ON_AIR_FIELDS[2] PROGMEM = {{16, 3, SRC_BAND, writeBand}, {27, 3, SRC_SWR, writeSWR}};
+const screen_field SWR_DISABLED_FIELDS[1] PROGMEM = {{28, 3, SRC_BAND, writeBand}};
+const screen_field USER_DATA_FIELDS[3] PROGMEM = {{0, 6, SRC_STATIC, writeCall}, {7, 7, SRC_GPS, writeLocator},
+                                                  {22, 4, SRC_STATIC, writePower}};
+const screen_field TIME_DATE_FIELDS[4] PROGMEM = {{0, 8, SRC_CLOCK, writeTime}, {9, 4, SRC_TEMP, writeTemp},
+                                                  {14, 1, SRC_STATIC, writeTempUnit}, {16, 15, SRC_DATE, writeDate}};
+const screen_field COORDINATES_FIELDS[8] PROGMEM = {{1, 2, SRC_GPS, writeLatLong}, {5, 2, SRC_GPS, writeLatLong},
+                                                    {9, 2, SRC_GPS, writeLatLong}, {13, 1, SRC_GPS, writeHemisphere},
+                                                    {17, 2, SRC_GPS, writeLatLong}, {21, 2, SRC_GPS, writeLatLong},
+                                                    {25, 2, SRC_GPS, writeLatLong},
+                                                    {29, 1, SRC_GPS, writeHemisphere}};
+const screen_field ALT_SPEED_FIELDS[4] PROGMEM = {{9, 5, SRC_GPS, writeAlt}, {14, 2, SRC_STATIC, writeDistUnit},
+                                                  {23, 3, SRC_GPS, writeSpeed}, {26, 4, SRC_STATIC, writeSpeedUnit}};
+const screen_field SUN_FIELDS[2] PROGMEM = {{5, 11, SRC_ASTRO, writeSunRiseSet},
+                                            {21, 11, SRC_ASTRO, writeSunRiseSet}};
+const screen_field MOON_FIELDS[2] PROGMEM = {{5, 11, SRC_ASTRO, writeMoonRiseSet},
+                                             {21, 11, SRC_ASTRO, writeMoonRiseSet}};
+const screen_field MOON_PHASE_FIELDS[2] PROGMEM = {{17, 3, SRC_ASTRO, writeMoonPhase},
+                                                   {22, 2, SRC_ASTRO, writeMoonTrend}};
+const screen_field LINK_FIELDS[4] PROGMEM = {{3, 4, SRC_CLOCK, writeLinkStats}, {12, 4, SRC_CLOCK, writeLinkStats},
+                                             {19, 4, SRC_CLOCK, writeLinkStats},
+                                             {28, 4, SRC_CLOCK, writeLinkStats}};
+
+const display_screen SCREENS[15] PROGMEM = {{TX_STANDBY, 0, 0},
+                                            {TX_ON_AIR, ON_AIR_FIELDS, 2},
+                                            {TX_SWR_DISABLED, SWR_DISABLED_FIELDS, 1},
+                                            {TX_SWR_DISABLED_ALL, 0, 0},
+                                            {TX_GPS_DISABLED, 0, 0},
+                                            {TX_HARDWARE_DISABLED, 0, 0},
+                                            {WAITING_FOR_GPS, 0, 0},
+                                            {USER_DATA, USER_DATA_FIELDS, 3},
+                                            {TIME_DATE, TIME_DATE_FIELDS, 4},
+                                            {COORDINATES_DISP, COORDINATES_FIELDS, 8},
+                                            {ALT_SPEED_DISP, ALT_SPEED_FIELDS, 4},
+                                            {SUN_DISP, SUN_FIELDS, 2},
+                                            {MOON_DISP, MOON_FIELDS, 2},
+                                            {MOON_PHASE_DISP, MOON_PHASE_FIELDS, 2},
+                                            {LINK_DISP, LINK_FIELDS, 4}};
+
+//##########################################################################################################
+
+// marks the data of a source as changed (its fields will be re-formatted with the next refresh)
+inline void touchSource(uint8_t source) {
+  src_version[source]++;
+}
+
+//##########################################################################################################
+
+// Renders a screen into the LCD buffer; if the screen is already held by the buffer, only those fields will be
+// re-formatted whose source data has changed since; returns 1 if anything has been rendered
+uint8_t renderScreen(uint8_t screen_id) {
+  display_screen s;
+  memcpy_P(&s, SCREENS + screen_id, sizeof(s));
+
+  uint8_t all = (screen_id != active_screen);
+  if(all) {
+    writeToBuffer(s.content);
+    active_screen = screen_id;
+  }
+
+  uint8_t rendered = all;
+  screen_field f;
+  for(uint8_t i=0; i<s.field_count; i++) {
+    memcpy_P(&f, s.fields + i, sizeof(f));
+    if(all || field_version[i] != src_version[f.source]) {
+      // restore the field's cells from the template
+      if(!all) {
+        for(uint8_t j=f.pos; j<f.pos+f.width; j++) {
+          lcd_content[j] = pgm_read_byte_near(s.content + j);
+        }
+      }
+      f.format(f.pos, f.width);
+      field_version[i] = src_version[f.source];
+      rendered = 1;
+    }
+  }
+
+  return rendered;
+}
+
+//##########################################################################################################
+
+// Selects the display content and updates the LCD; the fields of the active screen are refreshed by task 2
+void setDisplayContent() {
+  uint8_t screen_id = NO_SCREEN;
 
 // common part -> display transmitter status
   if(!disp_content_pointer) {
     if(!pulsing_on) {
-      writeToBuffer(TX_ON_AIR);
-      writeCharArray(band, 16, 3);
+      screen_id = SCREEN_ON_AIR;
       if(SWR_METER_INSTALLED) {
         // slow down content switching when SWR is being displayed
         scheduleTask(4, 140);
-        fast_refresh_pointer = 1;
-        scheduleTask(2, 0);
       }
     }
     else {
-	  // the maximum permissive age [seconds] of the last valid dataset before transmission will be suspended
+      // the maximum permissive age [seconds] of the last valid dataset before transmission will be suspended
       if(last_sync && (now()-last_sync) > 300) {
-        writeToBuffer(TX_GPS_DISABLED);
+        screen_id = SCREEN_GPS_DISABLED;
         gps_valid = 0;
       }
       else {
         if(td) {
-		  writeToBuffer(TX_HARDWARE_DISABLED);
+          screen_id = SCREEN_HARDWARE_DISABLED;
         }
         else {
           if(!swr_sum) {
-            writeToBuffer(TX_SWR_DISABLED);
-            lcd_content[25] = 32;
-            lcd_content[26] = 32;
-            lcd_content[31] = 32;
+            screen_id = SCREEN_SWR_DISABLED_ALL;
           }
           else {
             if(swr[band_pointer]>30) {
-              writeToBuffer(TX_SWR_DISABLED);
-              writeCharArray(band, 28, 3);
+              screen_id = SCREEN_SWR_DISABLED;
             }
             else {
-              writeToBuffer(TX_STANDBY);
+              screen_id = SCREEN_STANDBY;
             }
           }
         }
@@ -1024,37 +1632,15 @@ void setDisplayContent() {
   else {
     if(gps_valid) {
       switch(disp_content_pointer) {
-        case 1:// Display user settings   
-          writeToBuffer(USER_DATA);
-          writeCharArray(CALL, 0, 6);
-          writeCharArray(locator, 7, 4);
-          writeCharArray(loc, 12, 2);
-          writeNumber(POWER, 21, 0, 4);
+        case 1:// Display user settings
+          screen_id = SCREEN_USER_DATA;
         break;
         case 2:// display time, date & temp
-          // LCD_TIME_FIXED_ELEMENTS
-          writeToBuffer(TIME_DATE);
-          lcd_content[13] = 223;
-          // write temperature
-          writeNumber(temp, 8, 0, 3);
-          if(TEMP_SCALE) { lcd_content[14] = 'F'; }
-          // schedule rapid update of time & date
-          fast_refresh_pointer = 0;
-          scheduleTask(2, 0);
+          screen_id = SCREEN_TIME_DATE;
         break;
         case 3:
           if(COORDINATES) { // display longitude & latitude
-            uint8_t shift;
-            for(uint8_t i=0; i<2; ++i) {
-              shift = i*16;
-              lcd_content[3 + shift] = 223;
-              lcd_content[7 + shift] = '\'';
-              lcd_content[11 + shift] = '\"';
-              lcd_content[13 + shift] = lat_long[3][i];
-              for(uint8_t j=0; j<3; ++j) {
-                writeNumber(lat_long[j][i], -2 + (j<<2) + shift, 1, 2);
-              }
-            }
+            screen_id = SCREEN_COORDINATES;
           }
           else {
             scheduleTask(5, 0);
@@ -1062,26 +1648,7 @@ void setDisplayContent() {
         break;
         case 4:
           if(ALT_SPEED) { // display altitude and speed over ground
-            // LCD_ALT_SPEED_FIXED_ELEMENTS
-            writeToBuffer(ALT_SPEED_DISP);
-            if(DIST_UNIT) { // feet instead of meter
-              char ft[3] = "ft";
-              writeCharArray(ft, 14, 2);
-            }
-            writeNumber(alt, 9, 0, 4);
-
-            if(SPEED_UNIT) {
-              lcd_content[28] = 32;
-              lcd_content[29] = 32;
-              if(SPEED_UNIT & 1) { // mph instead of km/h
-                char mph[4] = "mph";
-                writeCharArray(mph, 26, 3);
-              }
-              else { // knots instead of km/h
-                lcd_content[27] = 'n';
-              }
-            }
-            writeNumber(sog, 21, 0, 3);
+            screen_id = SCREEN_ALT_SPEED;
           }
           else {
             scheduleTask(5, 0);
@@ -1089,9 +1656,7 @@ void setDisplayContent() {
         break;
         case 5:
           if(SUN && rs[0]) { // display Sun's set- and rise-time
-            // LCD_SUN_RISE_SET_FIXED_ELEMENTS
-            writeToBuffer(SUN_DISP);
-            writeRiseSet(0);
+            screen_id = SCREEN_SUN;
           }
           else {
             scheduleTask(5, 0);
@@ -1099,98 +1664,169 @@ void setDisplayContent() {
         break;
         case 6:
           if(MOON && rs[0]) { // display Moon's set- and rise-time
-            // LCD_MOON_RISE_SET_FIXED_ELEMENTS
-            writeToBuffer(MOON_DISP);
-            writeRiseSet(1);
+            screen_id = SCREEN_MOON;
           }
           else {
-            disp_content_pointer = MAX_DISP_CONTENT;
+            disp_content_pointer = MAX_DISP_CONTENT - 1;
             scheduleTask(5, 0);
           }
         break;
         case 7: // display Moon's phase
-          // LCD_MOON_RISE_SET_FIXED_ELEMENTS
-          writeToBuffer(MOON_PHASE_DISP);
-          writeNumber((abs(phase)+50)/100, 15, 0, 3);
-          if(phase > 0) {
-            char in[3] = "in";
-            writeCharArray(in, 23, 2);
+          screen_id = SCREEN_MOON_PHASE;
+        break;
+        case 8:
+          if(LINK_STATS) { // display the quality of the link to the GPS-module
+            screen_id = SCREEN_LINK;
+          }
+          else {
+            scheduleTask(5, 0);
           }
         break;
       }
     }
     else {
-      // LCD_WAITING_FOR_GPS_FIXED_ELEMENTS
-      writeToBuffer(WAITING_FOR_GPS);
-      disp_content_pointer = MAX_DISP_CONTENT;
+      // while waiting, the quality of the link is displayed alternately (e.g. to find out, why there's no data)
+      if(LINK_STATS && disp_content_pointer == MAX_DISP_CONTENT) {
+        screen_id = SCREEN_LINK;
+      }
+      else {
+        screen_id = SCREEN_WAITING_FOR_GPS;
+        disp_content_pointer = MAX_DISP_CONTENT - LINK_STATS;
+      }
     }
   }
 
 // increment the "display content pointer"
   disp_content_pointer = (disp_content_pointer == MAX_DISP_CONTENT) ? 0 : disp_content_pointer + 1;
-  
-  loadLCD();
+
+// screens being skipped leave the display unchanged
+  if(screen_id != NO_SCREEN) {
+    renderScreen(screen_id);
+    loadLCD();
+  }
 }
 
 //##########################################################################################################
 
-// Updates the LCD content (only values that have changed will be transferred)
+// Requests an update of the LCD content; the changed characters will be transferred by "serviceLCD"
+// within the following loop cycles, so the caller doesn't have to wait for the (slow) LCD
+// The transactions needed (a character per changed cell plus an address per run) are compared with those
+// needed after clearing the display (the clear instruction plus a character per non-blank cell and an address
+// per run), the cheaper way will be taken.
 void loadLCD() {
-  uint8_t c_pos = cursor_position;
-  uint8_t c_stat = cursor_status;
-  
+  uint8_t diff_cost = 0;
+  uint8_t clear_cost = 1;
+  uint8_t diff_run = 0;
+  uint8_t clear_run = 0;
+
   for(uint8_t i=0; i<DISPLAY_SIZE; i++) {
+    if(!(i & 15)) { diff_run = clear_run = 0; } // a run ends at the end of a line
+    if(lcd_content_last[i] != lcd_content[i]) {
+      diff_cost += diff_run ? 1 : 2;
+      diff_run = 1;
+    }
+    else { diff_run = 0; }
+    if(lcd_content[i] != ' ') {
+      clear_cost += (clear_run || !i) ? 1 : 2; // (clearing sets the address to 0)
+      clear_run = 1;
+    }
+    else { clear_run = 0; }
+  }
+
+  lcd_clear_pending = (clear_cost < diff_cost);
+  lcd_scan_pos = 0;
+  lcd_refresh_pending = 1;
+}
+
+//##########################################################################################################
+
+// Transfers pending LCD changes (only values that have changed will be transferred) with at most "budget"
+// bus transactions; consecutive changes are transferred as a run, i.e. the address is only set at the
+// beginning of each run and then automatically incremented by the LCD
+void serviceLCD(uint8_t budget) {
+  // after clearing, the LCD is busy for 1.6ms (the loop doesn't wait for it)
+  if(!lcd.ready()) { return; }
+  uint32_t probe = probeStart();
+
+  if(lcd_clear_pending) {
+    lcd.clear();
+    memset(lcd_content_last, ' ', DISPLAY_SIZE);
+    lcd_next_pos = 0;
+    lcd_clear_pending = 0;
+    --budget;
+  }
+
+  while(budget && lcd_scan_pos < DISPLAY_SIZE) {
+    uint8_t i = lcd_scan_pos;
     if(lcd_content_last[i] != lcd_content[i]) {
-      placeCursor(i, 0);
+      --budget;
+      if(i != lcd_next_pos) {
+        setLCDAddress(i);
+        continue; // the character will be written with the next transaction
+      }
       lcd.write(lcd_content[i]);
       lcd_content_last[i] = lcd_content[i];
+      // at the end of a line the address leaves the visible area
+      lcd_next_pos = ((i & 15) == 15) ? 0xFF : i + 1;
     }
+    ++lcd_scan_pos;
   }
-  
-  placeCursor(c_pos, c_stat);
+
+  if(lcd_scan_pos == DISPLAY_SIZE) {
+    // the cursor only needs to be restored if it's visible and has been moved
+    if(cursor_status && lcd_next_pos != cursor_position) {
+      if(budget) { placeCursor(cursor_position, cursor_status); }
+    }
+    else { lcd_refresh_pending = 0; }
+  }
+
+  probeStop(PROBE_LCD, probe);
+}
+
+//##########################################################################################################
+
+// Transfers all pending LCD changes at once (used where the loop isn't running, e.g. during setup)
+void flushLCD() {
+  loadLCD();
+  while(lcd_refresh_pending) { serviceLCD(0xFF); }
 }
 
 //##########################################################################################################
 
 // Sets the cursor to a given position (0...31)
 // with a given status (0==nothing; 1==only corsor; 2==only blinking; 3==blinking cursor)
+// the cursor status will only be sent to the LCD if it has changed
 void placeCursor(uint8_t c_pos, uint8_t c_stat) {
+  if(c_stat > 3) { c_stat = 0; }
+
   cursor_position = c_pos;
   cursor_status = c_stat;
   
-  uint8_t row = c_pos>>4;
-  if(c_pos > 15) {
-    c_pos -= 16;
-  }
-  lcd.setCursor(c_pos, row);
-
-  switch(c_stat) {
-    case 0:
-      lcd.noCursor();
-      lcd.noBlink();
-    break;
-    case 1:
-      lcd.cursor();
-      lcd.noBlink();
-    break;
-    case 2:
-      lcd.noCursor();
-      lcd.blink();
-    break;
-    case 3:
-      lcd.cursor();
-      lcd.blink();
-    break;
-    default:
-      lcd.noCursor();
-      lcd.noBlink();
+  setLCDAddress(c_pos);
+
+  if(c_stat != lcd_cursor_status) {
+    lcd_cursor_status = c_stat;
+
+    if(c_stat & 1) { lcd.cursor(); }
+    else { lcd.noCursor(); }
+    if(c_stat & 2) { lcd.blink(); }
+    else { lcd.noBlink(); }
   }
 }
 
 //##########################################################################################################
 
-// Writes a full set of 32 characters from an array to the LCD screen buffer
+// Sets the LCD's address (the position 0...31 the next character will be written to)
+void setLCDAddress(uint8_t pos) {
+  lcd.setCursor(pos & 15, pos>>4);
+  lcd_next_pos = pos;
+}
+
+//##########################################################################################################
+
+// Writes a full set of 32 characters from an array to the LCD screen buffer (no screen will be active anymore)
 void writeToBuffer(const uint8_t* array) {
+  active_screen = NO_SCREEN;
   for(uint8_t i=0; i<DISPLAY_SIZE; i++) {
     lcd_content[i] = pgm_read_byte_near(array + i);
   }
@@ -1202,40 +1838,8 @@ void writeToBuffer(const uint8_t* array) {
 // spanning from 0 to 3; the max. number of digits can be specified spanning from 1 to 4; neg. values will be
 // preceeded by "-"
 void writeNumber(int16_t number, int8_t pos, uint8_t leading_zeros, uint8_t max_digits) {
-  char text[6] = " 0000";
-  if(number < 0) {
-    number = abs(number);
-    text[0] = '-';
-  }
-
-  uint16_t dummy;
-  uint8_t e = 1;
-  int8_t sp = 1;
-  uint8_t ns = 1;
-  for(uint16_t i=1000; i>1; i/=10) {
-    dummy = number/i;
-    if(dummy) {
-      text[e] += dummy;
-      ns = 0;
-    }
-    else {
-      if(ns) { sp++; }
-    }
-    number %= i;
-    e++;
-  }
-  text[4] += number;
-  
-  sp -= leading_zeros;
-  if(sp < 1) { sp = 1; }
-  
-  uint8_t ssize = 5-max_digits;
-  if(ssize > sp) { sp = ssize; }
-  
-  if(text[0]=='-') {
-    sp--;
-    text[sp] = '-';
-  }
+  char text[5];
+  uint8_t sp = NF.format(number, text, leading_zeros, max_digits);
 
   writeCharArray(&text[sp], pos+sp, 5-sp);
 }
@@ -1255,14 +1859,19 @@ void writeCharArray(const char* char_array, uint8_t pos, uint8_t len) {
 
 // sets phase and restarts DDS
 // if shutdown is 1, DDS will shut down, reducing the dissipated power from 380mW to 30mW @5V
+// after a fast SWR-trip the DDS stays off until the "check SWR" routine has handled it
 void setPhaseValue(uint32_t deltaphase, uint8_t shutdown) {
+  if(swr_tripped) { deltaphase = 0; }
   dds.setPhase(deltaphase, 0, shutdown);
+  // a trip during the transfer has been overwritten by its remaining bits -> stop the DDS again
+  if(swr_tripped) { dds.emergencyStop(); }
 	
   if(deltaphase) {
     backlightPulsingOn(0);
   }
   else {
     SWR_check_active = 0;
+    adc_sampling = 0;
     symbol_counter = 0;
     on_air = 0;
     backlightPulsingOn(1);
@@ -1272,6 +1881,407 @@ void setPhaseValue(uint32_t deltaphase, uint8_t shutdown) {
 
 }
 
+//##########################################################################################################
+// functions used for the SWR-meter
+//##########################################################################################################
+
+// starts the interrupt-driven sampling of the SWR-meter (stopped by setting "adc_sampling" to 0; a conversion
+// in progress will then be completed by the isr without starting the next one)
+void startSWRSampling() {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    swr_sample_consumed = swr_sample_seq;
+    adc_sampling = 1;
+    // if the isr is still busy with the last conversion, it will continue the sequence by itself
+    if(!(ADCSRA & (1 << ADSC))) {
+      adc_ref_pending = 0;
+      ADMUX = adc_admux_fwd;
+      ADCSRA |= (1 << ADSC);
+    }
+  }
+}
+
+//##########################################################################################################
+
+// copies the newest sample pair; returns 0 if no new pair has been completed since the last call
+// the slot is read without disabling interrupts; if the isr might have overwritten it meanwhile, the (then)
+// newest pair will be read
+uint8_t getSWRSample(swr_sample *sample) {
+  uint8_t seq;
+  do {
+    seq = swr_sample_seq;
+    if(seq == swr_sample_consumed) { return 0; }
+    volatile swr_sample *slot = swr_ring + (seq & (SWR_RING_SIZE-1));
+    sample->fwd = slot->fwd;
+    sample->ref = slot->ref;
+    sample->stamp = slot->stamp;
+    // the isr writes slot "swr_sample_seq + 1"; it reaches the one just read after 3 more pairs
+  } while(uint8_t(swr_sample_seq - seq) >= SWR_RING_SIZE - 1);
+
+  swr_sample_consumed = seq;
+  return 1;
+}
+
+//##########################################################################################################
+// functions used for the GPS 1PPS-input
+//##########################################################################################################
+
+// arms timer 1 to start the current transmission exactly 1s after the PPS-edge marking the even minute; while
+// waiting, the "transmit symbol" and "check SWR" routines are put on hold
+// returns 0 if there is no valid PPS-signal
+uint8_t armPPSStart() {
+  uint8_t armed = 0;
+
+  if(PPS_INSTALLED && pps_valid) {
+    uint32_t age;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      age = micros() - pps_timestamp;
+    }
+
+    if(age < PPS_TIMEOUT) {
+      // the system clock is synchronised within some 10ms, hence the edge marking the even minute is either
+      // the last one received (age < 0.5s) or the next one to come
+      uint32_t wait = (age < 500000) ? 1000000 - age : 2000000 - age;
+
+      transmit_symbol_loop_counter = INT16_MIN;
+      ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        TCNT1 = 0; // initialize counter value to 0
+        OCR1A = wait>>6; // 64µs per tick
+        TIFR1 = (1 << OCF1A); // clear pending compare match
+        TCCR1B = (1 << WGM12) | (1 << CS12) | (1 << CS10); // CTC mode, prescaler 1024
+      }
+      armed = 1;
+    }
+  }
+
+  return armed;
+}
+
+//##########################################################################################################
+
+// invalidates the PPS-signal once the last edge is older than PPS_TIMEOUT
+void checkPPSTimeout() {
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    if(pps_valid && micros() - pps_timestamp >= PPS_TIMEOUT) { pps_valid = 0; }
+  }
+}
+
+//##########################################################################################################
+// functions used by the tickless idle mode
+//##########################################################################################################
+
+// returns the number of loop cycles that can be skipped, because none of the cyclical routines or scheduled tasks
+// will be due within them (routines that have nothing to do are not taken into account)
+uint16_t getIdleLoops() {
+  // the "system timer" is the only routine that is always active; it limits the result to 100ms
+  int32_t loops = SYSTEM_TIMER_LOOPS - system_timer_loop_counter;
+
+  if(on_air) {
+    loops = min(loops, int32_t(TRANSMIT_SYMBOL_LOOPS) - transmit_symbol_loop_counter);
+  }
+  if(PPS_INSTALLED && TCCR1B) { // a PPS-aligned transmission is about to start
+    uint16_t ticks;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+      ticks = OCR1A - TCNT1;
+    }
+    loops = min(loops, (int32_t(ticks)<<6)/TLR);
+  }
+  if(SWR_check_active) {
+    loops = min(loops, int32_t(CHECK_SWR_LOOPS) - check_SWR_loop_counter);
+  }
+  if(lcd_refresh_pending) { // LCD changes are transferred within the next loop cycles
+    loops = 0;
+  }
+  for(uint8_t i=0; i<=MID; i++) {
+    if(tl[i] > -1 && tl[i] <= timer) {
+      loops = min(loops, int32_t(SINGLE_TASK_SCHEDULER_LOOPS) - single_task_scheduler_loop_counter);
+      break;
+    }
+  }
+
+  if(loops < 0) { loops = 0; }
+
+  return loops;
+}
+
+//##########################################################################################################
+
+// advances all loop cycle counters by a given number of skipped cycles; counters of inactive routines will
+// stop at their trigger value (the routine will be executed with the next loop)
+void advanceLoopCounters(uint16_t skip) {
+  if(skip) {
+    transmit_symbol_loop_counter = min(int32_t(transmit_symbol_loop_counter) + skip, TRANSMIT_SYMBOL_LOOPS);
+    system_timer_loop_counter = min(uint32_t(system_timer_loop_counter) + skip, SYSTEM_TIMER_LOOPS);
+    single_task_scheduler_loop_counter = min(uint16_t(single_task_scheduler_loop_counter) + skip,
+                                             SINGLE_TASK_SCHEDULER_LOOPS);
+    check_SWR_loop_counter = min(int32_t(check_SWR_loop_counter) + skip, CHECK_SWR_LOOPS);
+  }
+}
+
+//##########################################################################################################
+
+// waits for a given time [µs]; the MCU sleeps as long as the next wake-up is guaranteed to be in time (idle mode:
+// by the timer 0 overflow interrupt; power-save mode: by timer 2 after whole timer 0 periods), the remainder will
+// be busy-waited; an event ("wake_event") ends the wait early; returns the time [µs] actually waited
+uint32_t idleWait(uint32_t wait) {
+  uint32_t start = micros();
+  uint32_t elapsed = 0;
+
+  while(!wake_event && elapsed + IDLE_SLEEP_MARGIN < wait) {
+    if(canPowerSave()) {
+      uint32_t slept = powerSave(min((wait - elapsed)>>10, uint32_t(PWR_SAVE_MAX_PERIODS)));
+      if(DIAGNOSTICS) { addTime(&pwr_save_time, slept); }
+    }
+    else {
+      set_sleep_mode(SLEEP_MODE_IDLE);
+      sleep_mode();
+    }
+    elapsed = micros() - start;
+  }
+  if(DIAGNOSTICS) { addTime(&sleep_time, elapsed); }
+  if(wake_event) { return elapsed; }
+
+  if(elapsed < wait) {
+    delayMicroseconds(wait - elapsed);
+    if(DIAGNOSTICS) { addTime(&spin_time, wait - elapsed); }
+  }
+
+  return wait;
+}
+
+//##########################################################################################################
+
+// returns 1 if the MCU may sleep in power-save mode, i.e. if no peripheral but timer 2 needs a clock: the backlight
+// PWM is off (timer 2 is free), the ADC doesn't sample, timer 1 isn't used (PPS-input, receiver input capture), the
+// serial interface is off and no dataset is expected
+uint8_t canPowerSave() {
+  if(pulsing_on || adc_sampling || PPS_INSTALLED || DIAGNOSTICS || GPS_INPUT_PIN == DR_ICP_PIN) { return 0; }
+
+  uint32_t last, gap;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    last = rx_last;
+    gap = rx_min_gap;
+  }
+
+  return gap > RX_GUARD && millis() - last < gap - RX_GUARD;
+}
+
+//##########################################################################################################
+
+// sleeps in power-save mode for a given number of timer 0 overflow periods (1...16) or until another interrupt wakes
+// the MCU, then advances micros() and millis() by the time slept; returns the time slept [µs]
+uint32_t powerSave(uint8_t periods) {
+  uint16_t ticks;
+
+  ATOMIC_BLOCK(ATOMIC_FORCEON) {
+    uint8_t tccr2a = TCCR2A;
+    uint8_t timsk2 = TIMSK2;
+
+    TCCR2A = (1 << WGM21); // CTC mode
+    TIMSK2 = (1 << OCIE2A); // enable timer compare interrupt (only)
+    OCR2A = (periods<<4) - 1;
+    TCNT2 = 0; // initialize counter value to 0
+    GTCCR = (1 << PSRASY); // reset the prescaler
+    TIFR2 = (1 << OCF2A) | (1 << OCF2B) | (1 << TOV2); // clear pending interrupts
+    TCCR2B = (1 << CS22) | (1 << CS21) | (1 << CS20); // prescaler 1024
+    pwr_save_timeout = 0;
+
+    set_sleep_mode(SLEEP_MODE_PWR_SAVE);
+    sleep_enable();
+    sei();
+    sleep_cpu(); // the interrupt waking the MCU is executed before the next instruction
+    cli();
+    sleep_disable();
+
+    TCCR2B = 0; // stop timer 2
+    ticks = pwr_save_timeout ? periods<<4 : TCNT2;
+    TCCR2A = tccr2a;
+    TIFR2 = (1 << OCF2A) | (1 << OCF2B) | (1 << TOV2);
+    TIMSK2 = timsk2;
+
+    // timer 0 (4µs per count) has been stopped: advance it by the ticks slept (16 counts per tick)
+    uint16_t counts = TCNT0 + (ticks<<4);
+    uint8_t overflows = counts>>8;
+    TCNT0 = counts;
+    timer0_overflow_count += overflows;
+    // 1.024ms per overflow (1ms + 3/125ms)
+    uint16_t fract = pwr_save_fract + 3*overflows;
+    timer0_millis += overflows + fract/125;
+    pwr_save_fract = fract%125;
+  }
+
+  return uint32_t(ticks)<<6;
+}
+
+//##########################################################################################################
+
+// adds a time span [µs] to a time account (called for each wait, so whole seconds are carried by subtraction
+// instead of dividing; the loop runs more than once only for spans above 1s)
+void addTime(time_acc *acc, uint32_t us) {
+  acc->us += us;
+  while(acc->us >= 1000000) {
+    acc->us -= 1000000;
+    acc->s++;
+  }
+}
+
+//##########################################################################################################
+
+// returns the time [ms] of a time account (for the report only, so the division doesn't matter)
+uint32_t getTimeMs(const time_acc *acc) {
+  return acc->s*1000 + acc->us/1000;
+}
+
+//##########################################################################################################
+
+// prints the power/cycle accounting of the main loop (time spent executing code, sleeping and busy-waiting)
+// and compares the estimated supply current of the MCU to the one of a permanently busy loop; the current is
+// calculated from the time shares and the typical figures above, it has not been measured
+void printPowerReport() {
+  uint32_t total = millis() - accounting_start;
+  uint32_t sleep_ms = getTimeMs(&sleep_time);
+  uint32_t pwr_save_ms = getTimeMs(&pwr_save_time);
+  uint32_t spin_ms = getTimeMs(&spin_time);
+  uint32_t idle = sleep_ms + spin_ms;
+  uint32_t active = (total > idle) ? total - idle : 0;
+
+  Serial.print(F("\n\nPower/cycle accounting over ")); Serial.print(total/1000); Serial.print(F("s ("));
+  if(TICKLESS_IDLE) { Serial.print(F("tickless idle mode")); }
+  else { Serial.print(F("busy loop")); }
+  Serial.print(F(")\nexecuting code: ")); printShare(active, total);
+  Serial.print(F("\nsleeping:       ")); printShare(sleep_ms, total);
+  Serial.print(F(" (power-save: ")); printShare(pwr_save_ms, total); Serial.print(F(")"));
+  Serial.print(F("\nbusy-waiting:   ")); printShare(spin_ms, total);
+
+  // estimated average MCU supply current in this mode and in busy loop (which never sleeps)
+  uint32_t idle_sleep = (sleep_ms > pwr_save_ms) ? sleep_ms - pwr_save_ms : 0;
+  float current = (float(total - sleep_ms)*ACTIVE_CURRENT + float(idle_sleep)*IDLE_CURRENT
+                   + float(pwr_save_ms)*PWR_SAVE_CURRENT)/max(total, 1);
+  Serial.print(F("\nMCU current (estimate, not measured): ")); Serial.print(current/1000, 2);
+  Serial.print(F("mA (busy loop: ")); Serial.print(float(ACTIVE_CURRENT)/1000, 2); Serial.print(F("mA)"));
+}
+
+//##########################################################################################################
+
+// prints a share of a total value in percent
+void printShare(uint32_t share, uint32_t total) {
+  float percent = 100.0*share/max(total, 1);
+  Serial.print(percent, 1); Serial.print(F("%"));
+}
+
+//##########################################################################################################
+
+// prints the link quality counters of the receiver, the datasets delivered per ID and the histogram of the time
+// between datasets
+void printLinkStats() {
+  dr_stats st;
+  DR.getStats(&st);
+
+  Serial.print(F("\n\nGPS-link (")); Serial.print(DR.getByteRate()); Serial.print(F(" Byte/s):"));
+  Serial.print(F("\npreambles: ")); Serial.print(st.preambles);
+  Serial.print(F("\ndelivered: ")); Serial.print(st.delivered);
+  Serial.print(F("\ntiming violations (<T1 / >T3): ")); Serial.print(st.short_intervals);
+  Serial.print(F(" / ")); Serial.print(st.long_intervals);
+  Serial.print(F("\nunknown IDs: ")); Serial.print(st.unknown_ids);
+  Serial.print(F("\ndropped (busy): ")); Serial.print(st.dropped);
+  Serial.print(F("\nCRC errors: ")); Serial.print(st.crc_errors);
+  Serial.print(F("\nFEC corrections: ")); Serial.print(st.fec_corrections);
+  for(uint8_t i=0; i<DATASET_COUNT; i++) {
+    Serial.print(F("\nID ")); Serial.print(dataset[i].ID); Serial.print(F(": "));
+    Serial.print(DR.getDelivered(i));
+  }
+
+  Serial.print(F("\n\nGap histogram [s]:"));
+  uint16_t limit = 1;
+  for(uint8_t i=0; i<DR_GAP_BINS; i++) {
+    Serial.print(F("\n"));
+    if(i < DR_GAP_BINS - 1) { Serial.print(F("< ")); }
+    else { Serial.print(F(">= ")); limit >>= 1; }
+    Serial.print(limit*1.024, 3); Serial.print(F(": ")); Serial.print(st.gaps[i]);
+    limit <<= 1;
+  }
+}
+
+//##########################################################################################################
+// functions used by the scheduler instrumentation
+//##########################################################################################################
+
+// returns the timestamp to measure the execution time of a code section from
+inline uint32_t probeStart() {
+  return SCHEDULER_STATS ? micros() : 0;
+}
+
+//##########################################################################################################
+
+// records the execution time of an instrumented code section which has started at a given timestamp
+void probeStop(uint8_t id, uint32_t start) {
+  if(SCHEDULER_STATS) {
+    uint32_t t = micros() - start;
+    exec_stats *stats = probe_stats + id;
+
+    if(t > 0xFFFF) { t = 0xFFFF; }
+    if(t > stats->max) { stats->max = t; }
+    // on saturation halve count and sum (keeps the mean value)
+    if(stats->count == 0xFFFF) {
+      stats->count >>= 1;
+      stats->sum >>= 1;
+    }
+    stats->count++;
+    stats->sum += t;
+  }
+}
+
+//##########################################################################################################
+
+// records the runtime of the loop (started at a given timestamp) in the loop runtime histogram
+void recordLoopTime(uint32_t start) {
+  if(SCHEDULER_STATS) {
+    uint32_t t = micros() - start;
+    uint32_t limit = TLR>>2;
+    uint8_t i = 0;
+    while(i < LOOP_HIST_SIZE - 1 && t >= limit) {
+      limit <<= 1;
+      i++;
+    }
+    if(loop_hist[i] < 0xFFFF) { loop_hist[i]++; }
+  }
+}
+
+//##########################################################################################################
+
+// resets all scheduler statistics
+void resetSchedulerStats() {
+  memset(probe_stats, 0, sizeof(probe_stats));
+  memset(loop_hist, 0, sizeof(loop_hist));
+  budget_resets = 0;
+}
+
+//##########################################################################################################
+
+// prints the scheduler statistics (execution times of all instrumented code sections and the loop runtime
+// histogram)
+void printSchedulerStats() {
+  Serial.print(F("\n\nExecution times [us] (count / mean / max):"));
+  for(uint8_t i=0; i<PROBE_COUNT; i++) {
+    Serial.print(F("\n"));
+    if(i <= MID) { Serial.print(F("task ")); Serial.print(i); }
+    else { Serial.print((const __FlashStringHelper*) PROBE_NAMES[i - MID - 1]); }
+    Serial.print(F(": ")); Serial.print(probe_stats[i].count);
+    Serial.print(F(" / ")); Serial.print(probe_stats[i].sum/max(probe_stats[i].count, 1));
+    Serial.print(F(" / ")); Serial.print(probe_stats[i].max);
+  }
+
+  Serial.print(F("\n\nLoop runtime histogram (TLR = ")); Serial.print(TLR); Serial.print(F("us):"));
+  uint16_t limit = 25;
+  for(uint8_t i=0; i<LOOP_HIST_SIZE; i++) {
+    Serial.print(F("\n"));
+    if(i < LOOP_HIST_SIZE - 1) { Serial.print(F("< ")); }
+    else { Serial.print(F(">= ")); limit >>= 1; }
+    Serial.print(limit); Serial.print(F("%: ")); Serial.print(loop_hist[i]);
+    limit <<= 1;
+  }
+  Serial.print(F("\nbudget resets: ")); Serial.print(budget_resets);
+}
+
 //##########################################################################################################
 // functions used for task scheduling
 //##########################################################################################################
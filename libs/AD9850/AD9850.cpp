@@ -123,3 +123,15 @@ void AD9850::setPhase(unsigned long deltaphase, unsigned char phase, boolean shu
   }
   else { dds_is_down = 0; }
 }
+
+//################################################################################################################
+
+// stops the output at once by a reset (frequency and phase set to 0) and restores the serial mode; meant to be
+// called from an interrupt routine (a transfer interrupted by it is corrupted and has to be repeated); the DDS is
+// not powered down
+void AD9850::emergencyStop() {
+  ddsPulse(RESET_PIN);
+  ddsPulse(W_CLK_PIN);
+  ddsPulse(FQ_UD_PIN);
+  dds_is_down = 0;
+}
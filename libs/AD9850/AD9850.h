@@ -38,6 +38,10 @@ public:
 // each step representing an angle of 11.25 degree)
 // if deltaphase is set to 0, DDS will shut down, reducing the dissipated power from 380mW to 30mW @5V
   void setPhase(unsigned long deltaphase, unsigned char phase, boolean shutdown);
+// stops the output at once by a reset (frequency and phase set to 0) and restores the serial mode; meant to be
+// called from an interrupt routine (a transfer interrupted by it is corrupted and has to be repeated); the DDS is
+// not powered down
+  void emergencyStop();
 // calculates the phase-value for a given frequency in Hz
   unsigned long calculatePhaseValue(unsigned long frequency);
 // calculates the frequency in Hz for a give phase-value
@@ -0,0 +1,51 @@
+/*
+  "CRC8"
+  library calculating the CRC8 (Dallas/Maxim, polynomial x^8+x^5+x^4+1, reflected) of the datasets exchanged
+  by "DataTransmitter" and "DataReceiver"
+  V1.0 / Copyright (C) 2017, T.Rode (DL1DUZ)
+
+  Permission is granted to use, copy, modify, and distribute this software
+  and documentation for non-commercial purposes.
+
+  Required ressources:
+   - 256 byte of flash (lookup table) or none (bitwise calculation, see CRC8_USE_TABLE)
+*/
+
+//################################################################################################################
+//includes
+//################################################################################################################
+
+#include <CRC8.h>
+
+//################################################################################################################
+//declarations
+//################################################################################################################
+
+#if CRC8_USE_TABLE
+// the lookup table, generated by the compiler
+#define CRC8_T4(i) crc8Bitwise(i), crc8Bitwise(i+1), crc8Bitwise(i+2), crc8Bitwise(i+3)
+#define CRC8_T16(i) CRC8_T4(i), CRC8_T4(i+4), CRC8_T4(i+8), CRC8_T4(i+12)
+#define CRC8_T64(i) CRC8_T16(i), CRC8_T16(i+16), CRC8_T16(i+32), CRC8_T16(i+48)
+
+const uint8_t CRC8_TABLE[256] PROGMEM = { CRC8_T64(0), CRC8_T64(64), CRC8_T64(128), CRC8_T64(192) };
+
+static_assert(crc8Bitwise(1) == 0x5E && crc8Bitwise(0x80) == 0x8C && crc8Bitwise(0xFF) == 0x35,
+              "CRC8 table generator is broken");
+#endif
+
+//################################################################################################################
+//public functions
+//################################################################################################################
+
+// returns the CRC of a dataset (the ID followed by SIZE byte of data)
+uint8_t CRC8Class::crcCalculation(const uint8_t ID, const uint8_t* DATA, const uint8_t SIZE) {
+  uint8_t crc = update(0, ID);
+
+  for(uint8_t i=0; i<SIZE; ++i) {
+    crc = update(crc, DATA[i]);
+  }
+
+  return crc;
+}
+
+CRC8Class CRC;
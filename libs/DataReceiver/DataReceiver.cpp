@@ -2,16 +2,19 @@
   "DataReceiver"
   Library supporting wireless or wire-bound serial data broadcasting
   (e.g. sensor data via a 2-wire connection or radio broadcast on an ISM-frequency)
-  The transmission is DC-free (Manchester-coded) and error-checked (CRC8)
-  Requires library "CRCGenerator"
+  The transmission is DC-free (Manchester-coded), error-checked (CRC8) and optionally error-corrected
+  (Hamming(8,4), for datasets with FEC_FLAG set in their ID)
+  Requires libraries "CRC8" and "HammingFEC"
   
-  V1.1 / Copyright (C) 2017, T.Rode (DL1DUZ)
+  V1.6 / Copyright (C) 2017, T.Rode (DL1DUZ)
 
   Permission is granted to use, copy, modify, and distribute this software
   and documentation for non-commercial purposes.
 
   Required ressources:
    - 1 digital, interrupt-capable input pin
+   - or the input capture pin of timer 1 (ICP1, DR_ICP_PIN); the edges will then be timestamped by hardware
+     (0.5µs resolution) and timer 1 can't be used otherwise
 */
 
 //################################################################################################################
@@ -26,6 +29,26 @@
 
 DataReceiverClass *DataReceiverClass::this_instance;
 
+// keeps the compiler from moving memory accesses across the update of head/tail
+#define DR_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+// the state of a slot: a valid dataset, codewords still to be decoded or a dataset failing the CRC-check after
+// decoding
+const uint8_t SLOT_VALID = 0;
+const uint8_t SLOT_FEC = 1;
+const uint8_t SLOT_INVALID = 2;
+
+// the half-bit period is tracked with 4 fractional bits and a loop gain of 1/8
+const uint8_t PLL_FRACTION = 4;
+const uint8_t PLL_GAIN = 3;
+// the max. half-bit period [ticks] (T3 has to fit into 16 bit)
+const uint16_t PERIOD_MAX = 26214;
+
+// increments a link quality counter (saturating at 65535)
+static inline void countEvent(uint16_t &counter) {
+  if(counter != 0xFFFF) { ++counter; }
+}
+
 //################################################################################################################
 //global functions
 //##############################################################################################################
@@ -34,84 +57,122 @@ void DataReceiverClass::isr() {
   this_instance -> DRisr();
 }
 
+#if DR_ICP_AVAILABLE
+// timer 1 input capture-isr (only enabled, if the receiver is connected to DR_ICP_PIN)
+ISR(TIMER1_CAPT_vect) {
+  DR.captureIsr();
+}
+#endif
+
 //################################################################################################################
 //private functions
 //################################################################################################################
 
-//interrupt service routine
+//interrupt service routine (pin change front end)
 
 void DataReceiverClass::DRisr() {
-  // Variable holding the microsecond-timestamp, when the interrupt service routine was last called.
-  static uint32_t msl = 0;
-  // A dummy to hold the current microsecond-timestamp.
-  static uint32_t msc;
-  // Variable holding the time in microseconds passed since the last call of the interrupt service routine.
-  static uint32_t dt;
-
-// Catch the current microsecond-timestamp when entering the interrupt service routine.
-  msc = micros();
-// calculate the time in μs passed since the last call of this routine.
-  dt = msc - msl;
-// Update the variable holding the timestamp of the last call of this routine.
-  msl = msc;
-
-// check dt against calculated time step thresholds
-  if(dt<T1 || dt>T3) {
+// Catch the current microsecond-timestamp when entering the interrupt service routine and calculate the time
+// in μs passed since the last call of this routine (limited to 16 bit, anything longer is invalid anyway)
+  uint32_t msc = micros();
+  uint32_t dt = msc - last_micros;
+  last_micros = msc;
+
+  decodeEdge(dt > 0xFFFF ? 0xFFFF : dt);
+}
+
+//################################################################################################################
+
+// decodes the Manchester-coded datastream; "dt" is the time passed since the previous edge in ticks of the
+// front end's timestamp
+
+void DataReceiverClass::decodeEdge(uint16_t dt) {
+// preamble: the half-bit period is taken from its two short intervals (within the range expected and of about
+// the same length), which follow a gap of 4 half-bit periods (or idle); a data stream has no such gap, so the
+// receiver can't lock onto a dataset already being transmitted
+  if(!int_counter) {
+    uint16_t diff = (dt > last_dt) ? dt - last_dt : last_dt - dt;
+    if(after_gap && dt >= h_min && dt <= h_max && diff < (last_dt >> 1)) {
+      period = (uint32_t)(dt + last_dt) << (PLL_FRACTION - 1);
+      setThresholds();
+      int_counter = 1;
+      countEvent(stats.preambles);
+    }
+    else {
+      after_gap = (last_dt > (((uint32_t)dt*5) >> 1));
+      last_dt = dt;
+    }
+  }
+// check dt against the time step thresholds
+  else if(dt<T1) {
+    countEvent(stats.short_intervals);
+    resetReception();
+  }
+  else if(dt>T3) {
+    countEvent(stats.long_intervals);
     resetReception();
   }
   else {
-    if(dt>T2 || !skip_next_short) {
+    uint8_t is_long = (dt>T2);
+    trackPeriod(is_long ? (dt >> 1) : dt);
+
+    if(is_long || !skip_next_short) {
       skip_next_short = 1;// set "skip next short pulse"-flag
 
-      if(int_counter) {//preamble was ok, data is being received
-	if(dt>T2) { // current bit != previous bit
-	  prev_bit = !prev_bit;
-	}
-	if(prev_bit) {//set bit
-	  byte_value += bit_value;
-	}
-
-   	if(bit_value & 0x80) { // last bit has been reached -> switch to next byte
-	  if(!byte_counter) {// this is the first Byte (ID-Byte)
-	    if(!status) {//check if data array is available
-	      uint8_t id_exists = 0;
-	      for(uint8_t i=0; i<dataset_count; ++i) {
-	        if((dataset+i)->ID==byte_value) {//... check if ID exists in this system and ...
-	          // ... if so, flag it as busy and record timestamp
-	          pos = i;
-	          status = 1;
-	          timestamp = millis() - Tl;
-		  storeData();
-		  id_exists = 1;
-		  break;
-		}
-	      }
-	      if(!id_exists) { resetReception(); } //if ID could not be found, reset reception
-	    }
-	    else {
-	      resetReception();
-	    }
-	  }
-	  else {
-	    storeData();
-            //terminate reception and set status to "data available" if last element has been stored
-	    if(byte_counter == (dataset+pos)->SIZE + 2) {
-	      status = 4;
-	      resetReception();
-	    }
-	  }
-	}
-	else {
-	  bit_value <<= 1; // bit_value *= 2
-	}
+      if(is_long) { // current bit != previous bit
+        prev_bit = !prev_bit;
+      }
+      if(prev_bit) {//set bit
+        byte_value += bit_value;
+      }
+
+      if(bit_value & 0x80) { // last bit has been reached -> switch to next byte
+        if(!byte_counter) {// this is the first Byte (ID-Byte)
+          uint8_t id_exists = 0;
+          uint8_t i = 0;
+          for(; i<dataset_count; ++i) {
+            if((dataset+i)->ID==byte_value) {//check if ID exists in this system and ...
+              if(uint8_t(head - tail) < slot_count) {//... if a slot is available
+                // if so, flag it as busy and record position and timestamp
+                uint8_t slot = head & (slot_count - 1);
+                pos = i;
+                writing = 1;
+                write_array = data_array + slot*(array_size + 2);
+                slot_pos[slot] = i;
+                slot_timestamp[slot] = millis() - (((period >> PLL_FRACTION)*tl_factor) >> 11);
+                slot_state[slot] = (byte_value & FEC_FLAG) ? SLOT_FEC : SLOT_VALID;
+                frame_size = drFrameSize(byte_value, (dataset+i)->SIZE) + 2;
+                storeData();
+                id_exists = 1;
+              }
+              else { countEvent(stats.dropped); }
+              break;
+            }
+          }
+          if(i == dataset_count) { countEvent(stats.unknown_ids); }
+          if(!id_exists) { resetReception(); } //if ID could not be found or all slots are in use, reset reception
+        }
+        else {
+          storeData();
+          //terminate reception if last element has been stored and hand the slot over to the main loop, if the
+          //CRC matches (otherwise the slot will be reused); codewords are decoded and checked by the main loop
+          if(byte_counter == frame_size) {
+            uint8_t is_valid = (*write_array & FEC_FLAG) || (crc == *(write_array + 1));
+            if(is_valid) {
+              uint8_t slot = head & (slot_count - 1);
+              countGap(slot_timestamp[slot]);
+              if(slot_state[slot] == SLOT_VALID) { countDelivered(slot); }
+              last_period = period >> PLL_FRACTION;
+              DR_BARRIER();
+              ++head;
+            }
+            else { countEvent(stats.crc_errors); }
+            resetReception();
+            if(is_valid && ready_function) { ready_function(); } // raise the "dataset ready"-event
+          }
+        }
       }
-      else {//preamble is being received
-	if(dt>T2) {//peramble-syntax has been violated -> cancel reception
-	  resetReception();
-	}
-	else {
-	  ++int_counter;
-	}
+      else {
+        bit_value <<= 1; // bit_value *= 2
       }
     }
     else {
@@ -122,75 +183,245 @@ void DataReceiverClass::DRisr() {
 
 //################################################################################################################
 
-// support function for the ISR
+// support functions for the ISR
+
+// the half-bit period follows the intervals measured ("half" -> a short one or half of a long one), so that
+// the thresholds stay centered, even if the transmitter's clock deviates from the nominal byte rate
+
+void DataReceiverClass::trackPeriod(uint16_t half) {
+  period += ((int32_t)((uint32_t)half << PLL_FRACTION) - (int32_t)period) >> PLL_GAIN;
+  if(period > ((uint32_t)PERIOD_MAX << PLL_FRACTION)) { period = (uint32_t)PERIOD_MAX << PLL_FRACTION; }
+  setThresholds();
+}
+
+// short intervals are 1, long ones 2 half-bit periods: T1 = 0.5, T2 = 1.5 and T3 = 2.5 half-bit periods
+
+void DataReceiverClass::setThresholds() {
+  uint16_t h = period >> PLL_FRACTION;
+  T1 = h >> 1;
+  T2 = h + T1;
+  T3 = T2 + h;
+}
 
 void DataReceiverClass::resetReception() {
   int_counter = 0;
+  last_dt = 0;
+  after_gap = 0;
   byte_counter = 0;
   bit_value = 1;
   byte_value = 0;
   prev_bit = 1;
   skip_next_short = 1;
+  crc = 0;
 
-  if(status & 1) {//check if dataset is being written and if so, reset flag
-    status = 0;
-  }
+  writing = 0; // an incomplete dataset is discarded (its slot will be reused)
 }
 
 // ######################################################################################################################
 
-// support function for the ISR
+// support function for the ISR; the CRC is updated with each byte received (except the CRC-byte itself), so it's
+// ready for comparison when the last byte has arrived
 
 void DataReceiverClass::storeData() {
-  *(data_array + byte_counter) = byte_value; // transfer received byte into array
+  *(write_array + byte_counter) = byte_value; // transfer received byte into array
+  if(byte_counter != 1) { crc = CRC8Class::update(crc, byte_value); }
   bit_value = 1; // reset bit-value to first bit
   byte_value = 0; // reset byte-value
   ++byte_counter; // increment byte-counter
 }
 
+//################################################################################################################
+
+// returns the size of the biggest dataset
+
+uint8_t DataReceiverClass::getMaxSize(const dset_r* dsets, const uint8_t DATASET_COUNT) {
+  uint8_t size = 0;
+  for(uint8_t i=0; i<DATASET_COUNT; ++i) {
+    size = max(size, drFrameSize((dsets+i)->ID, (dsets+i)->SIZE));
+  }
+
+  return size;
+}
+
+//################################################################################################################
+
+// decodes the codewords of the oldest dataset in place (each block of 8 is read before its 4 byte are written)
+// and checks its CRC; returns 1 if matching, otherwise returns 0
+
+uint8_t DataReceiverClass::decodeFEC() {
+  uint8_t *array = readArray();
+  dset_r *d = dataset + getPos();
+  uint8_t block[8];
+  uint8_t corrected;
+
+  for(uint8_t i=0, blocks=fecEncodedSize(d->SIZE)>>3; i<blocks; ++i) {
+    memcpy(block, array + 1 + (i<<3), 8);
+    corrected = FEC.decodeBlock(block, array + 1 + (i<<2));
+    if(corrected != FEC_UNCORRECTABLE) {
+      stats.fec_corrections = min((uint32_t)stats.fec_corrections + corrected, 0xFFFFUL);
+    }
+  }
+
+  return (*(array+1) == CRC.crcCalculation(d->ID, array+2, d->SIZE));
+}
+
+//################################################################################################################
+
+// support functions for the link quality counters
+
+// sorts the time passed since the beginning of the previous dataset handed over into the gap histogram
+// (class i: gap>>10 < 2^i, i.e. one iteration per class at most)
+
+void DataReceiverClass::countGap(uint32_t timestamp) {
+  if(has_last_frame) {
+    int32_t gap = timestamp - last_frame; // the latency compensation may reorder close timestamps
+    uint32_t g = (gap > 0) ? ((uint32_t)gap >> 10) : 0;
+    uint8_t i = 0;
+    while(g && i < DR_GAP_BINS - 1) {
+      g >>= 1;
+      ++i;
+    }
+    countEvent(stats.gaps[i]);
+  }
+  last_frame = timestamp;
+  has_last_frame = 1;
+}
+
+// counts a valid dataset (per ID and in total); called with interrupts disabled
+
+void DataReceiverClass::countDelivered(uint8_t slot) {
+  countEvent((dataset + slot_pos[slot])->delivered);
+  countEvent(stats.delivered);
+}
+
+//################################################################################################################
+
+// returns a pointer to the slot holding the oldest dataset not yet released by the main loop
+
+uint8_t* DataReceiverClass::readArray() {
+  return data_array + (tail & (slot_count - 1))*(array_size + 2);
+}
+
 //################################################################################################################
 //public functions
 //################################################################################################################
 
+#if DR_ICP_AVAILABLE
+// interrupt service routine (input capture front end); the capture edge is toggled after each edge
+
+void DataReceiverClass::captureIsr() {
+  uint16_t capture = ICR1;
+  TCCR1B ^= (1 << ICES1);
+  TIFR1 = (1 << ICF1); // the flag has to be cleared after changing the edge
+
+  uint16_t dt = capture - last_capture;
+  last_capture = capture;
+
+  decodeEdge(dt);
+}
+#endif
+
+//################################################################################################################
+
 /*
-initializes the library
+initializes the library, allocating the receive buffer
 returns 1 if successfurl, otherwise 0
 
-"BYTE_RATE" -> the target gross data transfer rate in Byte/s set at the transmitter. Valid entries are 4...255.
-"RECEIVER_PIN" -> the digital, interrupt-capable pin the receiver is connected to
+"BYTE_RATE" -> the target gross data transfer rate in Byte/s set at the transmitter. Valid entries are 4...255 or
+ DR_AUTO_BAUD (the rate is detected from the preamble of each dataset).
+"RECEIVER_PIN" -> the digital, interrupt-capable pin the receiver is connected to (DR_ICP_PIN -> input capture)
 "dsets" -> array of "dset_r", holding all parameter relevant for the datasets
 "DATASET_COUNT" -> the number of datasets
+"SLOTS" -> the number of receive buffers (1, 2 or 4); while the main loop processes a dataset, the following ones
+           are received into the other slots
 */
 
 uint8_t DataReceiverClass::init(const uint8_t BYTE_RATE, const uint8_t RECEIVER_PIN, dset_r* dsets,
-                                const uint8_t DATASET_COUNT) {
-  if(!is_initialized && BYTE_RATE>3 && DATASET_COUNT) {
-    receiver_input = RECEIVER_PIN;
-    pinMode(receiver_input, INPUT);
+                                const uint8_t DATASET_COUNT, const uint8_t SLOTS) {
+  if(!is_initialized && DATASET_COUNT && SLOTS && SLOTS <= DR_MAX_SLOTS && !(SLOTS & (SLOTS-1))) {
+    uint16_t size = drBufferSize(SLOTS, getMaxSize(dsets, DATASET_COUNT));
+    uint8_t* buffer = (uint8_t*) malloc(size);
+    if(buffer != NULL && !init(BYTE_RATE, RECEIVER_PIN, dsets, DATASET_COUNT, buffer, size)) {
+      free(buffer);
+    }
+  }
+
+  return is_initialized;
+}
+
+//################################################################################################################
+
+/*
+initializes the library with a receive buffer provided by the caller (e.g. a static array sized by
+"drBufferSize"); it's divided into as many slots as fit (1, 2 or 4)
+returns 1 if successfurl, otherwise 0
+
+"BYTE_RATE", "RECEIVER_PIN", "dsets", "DATASET_COUNT" -> see above
+"BUFFER" -> the receive buffer
+"BUFFER_SIZE" -> its size in byte
+*/
 
+uint8_t DataReceiverClass::init(const uint8_t BYTE_RATE, const uint8_t RECEIVER_PIN, dset_r* dsets,
+                                const uint8_t DATASET_COUNT, uint8_t* BUFFER, const uint16_t BUFFER_SIZE) {
+  if(!is_initialized && (BYTE_RATE>3 || BYTE_RATE == DR_AUTO_BAUD) && DATASET_COUNT && BUFFER != NULL) {
+    for(uint8_t i=0; i<DATASET_COUNT; ++i) {
+      if(((dsets+i)->ID & FEC_FLAG) && (dsets+i)->SIZE > FEC_MAX_SIZE) { return 0; }
+    }
     dataset = dsets;
     dataset_count = DATASET_COUNT;
+    resetStats();
 
-    // allocate memory matching the size of the biggest dataset
-    array_size = 0;
-    for(uint8_t i=0; i<dataset_count; ++i) {
-      array_size = max(array_size, (dataset+i)->SIZE);
+    // the slots have to match the size of the biggest dataset
+    array_size = getMaxSize(dataset, dataset_count);
+    slot_count = DR_MAX_SLOTS;
+    while(slot_count && drBufferSize(slot_count, array_size) > BUFFER_SIZE) {
+      slot_count >>= 1;
     }
-    data_array = (uint8_t*) malloc(array_size + 2);
-    if(data_array != NULL) {
+    if(slot_count) {
+      data_array = BUFFER;
+      is_initialized = 1;
+
+      receiver_input = RECEIVER_PIN;
+      pinMode(receiver_input, INPUT);
     
-      // calculate time step threshold [μs] for given Byte-rate
-      T1 = 31250/BYTE_RATE;
-      T2 = 3*T1;
-      T3 = 5*T1;
-      Tl = 1375/BYTE_RATE; // 44*T1
+      // the ticks of the timestamp per 1/16s (i.e. the half-bit period at 1 Byte/s): 1μs; on the ICP-pin timer 1
+      // runs freely with prescaler 8 (0.5μs); the gap preceding the preamble (4 half-bit periods) has to fit into
+      // 16 bit (with some margin), so fixed byte rates below 12 need prescaler 64 (4μs)
+      use_icp = (receiver_input == DR_ICP_PIN);
+      uint8_t is_slow = use_icp && BYTE_RATE != DR_AUTO_BAUD && BYTE_RATE < 12;
+      tick_rate = use_icp ? (is_slow ? 15625 : 125000) : 62500;
+      // the latency [ms] between beginning of transmission and recognition of the ID is 22 half-bit periods
+      tl_factor = 2816000/tick_rate; // 22*1000*2048/16/tick_rate
+
+      // the range of half-bit periods [ticks] accepted from the preamble: 255*1.25...4/1.25 Byte/s (10 Byte/s at the
+      // ICP-pin) if the rate is detected automatically, otherwise the nominal period +-50%
+      if(BYTE_RATE == DR_AUTO_BAUD) {
+        h_min = tick_rate/320;
+        h_max = use_icp ? 0x3FFF : tick_rate*5/16;
+      }
+      else {
+        uint16_t h = tick_rate/BYTE_RATE;
+        h_min = h >> 1;
+        h_max = min((uint32_t)h + (h >> 1), (uint32_t)PERIOD_MAX);
+      }
 
       resetReception(); // just to initialize the variables
 
       this_instance = this;
-      attachInterrupt(digitalPinToInterrupt(receiver_input), isr, CHANGE);
+#if DR_ICP_AVAILABLE
+      if(use_icp) {
+        uint8_t sreg = SREG;
+        cli();
+        TCCR1A = 0; // normal mode
+        // noise canceler on, first capture on the edge opposite to the current input level
+        TCCR1B = (1 << ICNC1) | (digitalRead(receiver_input) ? 0 : (1 << ICES1)) |
+                 (is_slow ? ((1 << CS11) | (1 << CS10)) : (1 << CS11));
+        TIFR1 = (1 << ICF1);
+        SREG = sreg;
+      }
+#endif
+      enableReceiverInput(1);
 
-      is_initialized = 1;
     }
   }
 
@@ -199,15 +430,30 @@ uint8_t DataReceiverClass::init(const uint8_t BYTE_RATE, const uint8_t RECEIVER_
 
 //################################################################################################################
 
-// enables/disables the receiver by turning the interrupt on/off
+// enables/disables the receiver by turning the interrupt (pin change or input capture) on/off
 
 void DataReceiverClass::enableReceiverInput(const uint8_t ENABLE) {
   if(is_initialized) {
-    if(ENABLE) {
-      attachInterrupt(digitalPinToInterrupt(receiver_input), isr, CHANGE);
+#if DR_ICP_AVAILABLE
+    if(use_icp) {
+      uint8_t sreg = SREG;
+      cli();
+      if(ENABLE) {
+        TIFR1 = (1 << ICF1);
+        TIMSK1 |= (1 << ICIE1);
+      }
+      else { TIMSK1 &= ~(1 << ICIE1); }
+      SREG = sreg;
     }
-    else {
-      detachInterrupt(digitalPinToInterrupt(receiver_input));
+    else
+#endif
+    {
+      if(ENABLE) {
+        attachInterrupt(digitalPinToInterrupt(receiver_input), isr, CHANGE);
+      }
+      else {
+        detachInterrupt(digitalPinToInterrupt(receiver_input));
+      }
     }
   }
 }
@@ -228,6 +474,7 @@ dset_r DataReceiverClass::createDataset(const uint8_t ID, const uint8_t SIZE, co
   dummy.ID = ID; //the ID of the dataset
   dummy.SIZE = SIZE; // number of elements
   dummy.FUNCTION = FUNCTION; // a function to be called for data-processing
+  dummy.delivered = 0;
 
   return dummy;
 }
@@ -235,85 +482,247 @@ dset_r DataReceiverClass::createDataset(const uint8_t ID, const uint8_t SIZE, co
 //################################################################################################################
 
 /*
-returns the status of the data array (idle = 0; busy writing = 1; busy reading = 2; data available = 4)
+returns the status of the receiver as a combination of flags: a dataset is being received = 1; the oldest dataset
+is being read = 2; a dataset is available = 4 (idle = 0)
 */
 uint8_t DataReceiverClass::getStatus() {
-  return status;
+  uint8_t stat = writing;
+  if(head != tail) { stat |= reading ? 2 : 4; }
+
+  return stat;
 }
 
 //################################################################################################################
 
 /*
-sets the status of the data array (idle = 0; busy writing = 1; busy reading = 2; data available = 4)
+sets the status of the oldest dataset: busy reading = 2 marks it as being processed; idle = 0 releases its slot
+(the next dataset, if any, becomes available); no interrupts need to be disabled for this
 */
 void DataReceiverClass::setStatus(uint8_t stat) {
-  status = stat;
+  if(stat == 2) { reading = 1; }
+  if(!stat && head != tail) {
+    reading = 0;
+    DR_BARRIER();
+    ++tail;
+  }
 }
 
 //################################################################################################################
 
 /*
-returns the timestamp [ms] of the data array (time when reception started, latencies accounted for)
+returns the timestamp [ms] of the oldest dataset (time when reception started, latencies accounted for)
 */
 uint32_t DataReceiverClass::getTimestamp() {
-  return timestamp;
+  return slot_timestamp[tail & (slot_count - 1)];
 }
 
 //################################################################################################################
 
 /*
-returns the ID-value currently stored in the data-array (the ID of the dataset last received)
+returns the ID-value of the oldest dataset (the ID of the dataset to be processed next)
 */
 uint8_t DataReceiverClass::getID() {
-  return *data_array;
+  return *readArray();
 }
 
 //################################################################################################################
 
 /*
-returns the element-id of the dataset corresponding to the ID-value currently stored in the array
+returns the element-id of the dataset corresponding to the ID-value of the oldest dataset
 i.e. if the ID received corresponds to dataset[3] then this function would return 3
 */
 uint8_t DataReceiverClass::getPos() {
-  return pos;
+  return slot_pos[tail & (slot_count - 1)];
 }
 
 //################################################################################################################
 
 /*
-returns the CRC-value currently stored in the array
+returns the CRC-value of the oldest dataset
 */
 uint8_t DataReceiverClass::getCRC() {
-  return *(data_array + 1);
+  return *(readArray() + 1);
 }
 
 //################################################################################################################
 
 /*
-returns a pointer to the data section of the data array
+returns a pointer to the data section of the oldest dataset
 */
 uint8_t* DataReceiverClass::getDataArray() {
-  return (data_array + 2);
+  return (readArray() + 2);
+}
+
+//################################################################################################################
+
+/*
+returns the number of datasets dropped because all slots were in use
+*/
+uint16_t DataReceiverClass::getDropped() {
+  uint16_t d;
+  uint8_t sreg = SREG;
+  cli();
+  d = stats.dropped;
+  SREG = sreg;
+
+  return d;
+}
+
+//################################################################################################################
+
+/*
+returns the number of datasets discarded because of a CRC mismatch
+*/
+uint16_t DataReceiverClass::getCRCErrors() {
+  uint16_t e;
+  uint8_t sreg = SREG;
+  cli();
+  e = stats.crc_errors;
+  SREG = sreg;
+
+  return e;
+}
+
+//################################################################################################################
+
+/*
+returns the number of bit errors corrected by the forward error correction
+*/
+uint16_t DataReceiverClass::getFECCorrections() {
+  uint16_t c;
+  uint8_t sreg = SREG;
+  cli();
+  c = stats.fec_corrections;
+  SREG = sreg;
+
+  return c;
+}
+
+//################################################################################################################
+
+/*
+returns the number of datasets handed over valid for a dataset (i.e. processed by "dispatch"), see "getStats"
+
+"POS" -> the position of the dataset in "dset_r"
+*/
+uint16_t DataReceiverClass::getDelivered(const uint8_t POS) {
+  uint16_t d = 0;
+  if(is_initialized && POS < dataset_count) {
+    uint8_t sreg = SREG;
+    cli();
+    d = (dataset + POS)->delivered;
+    SREG = sreg;
+  }
+
+  return d;
+}
+
+//################################################################################################################
+
+/*
+copies the link quality counters (see "dr_stats") at one instant, so that they are consistent with each other
+
+"STATS" -> a pointer to the structure receiving the counters
+*/
+void DataReceiverClass::getStats(dr_stats* STATS) {
+  uint8_t sreg = SREG;
+  cli();
+  *STATS = stats;
+  SREG = sreg;
+}
+
+//################################################################################################################
+
+/*
+clears the link quality counters (including those of the datasets) and the gap histogram
+*/
+void DataReceiverClass::resetStats() {
+  uint8_t sreg = SREG;
+  cli();
+  memset(&stats, 0, sizeof(stats));
+  for(uint8_t i=0; i<dataset_count; ++i) {
+    (dataset+i)->delivered = 0;
+  }
+  has_last_frame = 0;
+  SREG = sreg;
+}
+
+//################################################################################################################
+
+/*
+returns the byte rate [Byte/s] measured while receiving the last dataset (0 -> none received yet), e.g. to check
+the rate detected automatically or the transmitter's clock
+*/
+uint8_t DataReceiverClass::getByteRate() {
+  uint16_t p;
+  uint8_t sreg = SREG;
+  cli();
+  p = last_period;
+  SREG = sreg;
+
+  return p ? min((tick_rate + (p >> 1))/p, 255UL) : 0;
+}
+
+//################################################################################################################
+
+/*
+sets a function to be called by the isr whenever a dataset has been received completely (e.g. to schedule its
+processing by "dispatch"); keep it short, as it's executed within the interrupt service routine
+
+"FUNCTION" -> the function to be called (NULL == none)
+*/
+void DataReceiverClass::onDatasetReady(const f_ptr FUNCTION) {
+  ready_function = FUNCTION;
+}
+
+//################################################################################################################
+
+/*
+processes all datasets available by calling their functions; datasets failing the CRC-check after the forward
+error correction are released unprocessed; interrupts stay enabled, so the reception continues meanwhile
+returns the number of datasets processed
+*/
+uint8_t DataReceiverClass::dispatch() {
+  uint8_t count = 0;
+
+  while(getStatus() & 4) {
+    if(validateData()) {
+      setStatus(2);
+      (dataset + getPos())->FUNCTION();
+      ++count;
+    }
+    setStatus(0);
+  }
+
+  return count;
 }
 
 //################################################################################################################
 
-// calculates the CRC for the dataset currently in the buffer and compares it to the one received
-// returns 1 if matching, otherwise returns 0
+// returns 1 if the oldest dataset is valid, otherwise returns 0; the CRC is checked by the isr as the bytes arrive
+// and datasets failing it are never handed over; datasets transmitted with forward error correction are decoded
+// and checked here (once)
 
 uint8_t DataReceiverClass::validateData() {
-  uint8_t is_valid = 0;
-  if(*(data_array+1) == CRC.crcCalculation((dataset+pos)->ID, data_array+2, (dataset+pos)->SIZE)) {
-    is_valid = 1;
+  if(head == tail) { return 0; }
+
+  uint8_t slot = tail & (slot_count - 1);
+  if(slot_state[slot] == SLOT_FEC) {
+    slot_state[slot] = decodeFEC() ? SLOT_VALID : SLOT_INVALID;
+    uint8_t sreg = SREG;
+    cli();
+    if(slot_state[slot] == SLOT_VALID) { countDelivered(slot); }
+    else { countEvent(stats.crc_errors); }
+    SREG = sreg;
   }
 
-  return is_valid;
+  return (slot_state[slot] == SLOT_VALID);
 }
 
 //################################################################################################################
 
 /*
-reads/writes an arbitrary type of data from/to the data array
+reads/writes an arbitrary type of data from/to the oldest dataset
 this function will return 0 in case of an error or 255 if the array goes out of scope, otherwise it will return
 the next position in the data array
 
@@ -328,12 +737,13 @@ uint8_t DataReceiverClass::dataTransfer(const void* X, const uint16_t SCOPE, con
   uint8_t next = 0;
 
   if(SCOPE && (SCOPE <= array_size-POS)) {
+    uint8_t *array = readArray();
     for(uint16_t i=0; i<SCOPE; ++i) {
       if(WRITE) {
-        *(data_array + POS + i + 2) = *(((uint8_t*) X) + i);
+        *(array + POS + i + 2) = *(((uint8_t*) X) + i);
       }
       else {
-        *(((uint8_t*) X) + i) = *(data_array + POS + i + 2);
+        *(((uint8_t*) X) + i) = *(array + POS + i + 2);
       }
     }
     next = POS + SCOPE;
@@ -0,0 +1,308 @@
+/*
+  "HD44780"
+  library driving HD44780-compatible character LCDs in 4-bit mode by direct port access
+  V1.0 / Copyright (C) 2017, T.Rode (DL1DUZ)
+
+  Permission is granted to use, copy, modify, and distribute this software
+  and documentation for non-commercial purposes.
+
+  Required ressources:
+   - 6 digital output pins (RS, E, D4...D7), optionally 1 more for R/W (busy-flag mode)
+   - D4...D7 should be connected to the same port (any bit order) so that each nibble can be written with one
+     port operation; otherwise slow "digitalWrite" calls will be used and the busy-flag mode is not available
+*/
+
+//################################################################################################################
+//includes
+//################################################################################################################
+
+#include <HD44780.h>
+
+//################################################################################################################
+//declarations
+//################################################################################################################
+
+// instructions
+const uint8_t CLEAR_DISPLAY = 0x01;
+const uint8_t RETURN_HOME = 0x02;
+const uint8_t ENTRY_MODE_INCREMENT = 0x06;
+const uint8_t DISPLAY_CONTROL = 0x08;
+const uint8_t DISPLAY_ON = 0x04;
+const uint8_t CURSOR_ON = 0x02;
+const uint8_t BLINK_ON = 0x01;
+const uint8_t FUNCTION_SET_8BIT = 0x03; // high nibble of "function set" (8-bit interface), sent as a nibble
+const uint8_t FUNCTION_SET_4BIT = 0x02; // high nibble of "function set" (4-bit interface), sent as a nibble
+const uint8_t FUNCTION_SET = 0x20;
+const uint8_t TWO_LINES = 0x08;
+const uint8_t SET_DDRAM_ADDRESS = 0x80;
+
+// execution times [µs] (HD44780 datasheet @ 270kHz plus some margin for slower clones)
+const uint16_t EXEC_TIME = 40;
+const uint16_t EXEC_TIME_HOME = 1600;
+
+// waits 500ns (8 cycles @ 16MHz); the minimum enable pulse width is 450ns, the enable cycle time 1000ns
+#define HD44780_DELAY_500NS() __asm__ __volatile__("nop\n\tnop\n\tnop\n\tnop\n\tnop\n\tnop\n\tnop\n\tnop\n\t")
+
+//################################################################################################################
+//constructor
+//################################################################################################################
+
+// RS_PIN, ENABLE_PIN, D4_PIN, D5_PIN, D6_PIN, D7_PIN, RW_PIN (optional)
+HD44780::HD44780(unsigned char rs_pin, unsigned char enable_pin, unsigned char d4_pin, unsigned char d5_pin,
+                 unsigned char d6_pin, unsigned char d7_pin, unsigned char rw_pin) {
+// resolve ports and bit masks once, so that no pin mapping is required at runtime
+  rs_port = portOutputRegister(digitalPinToPort(rs_pin));
+  rs_mask = digitalPinToBitMask(rs_pin);
+  en_port = portOutputRegister(digitalPinToPort(enable_pin));
+  en_mask = digitalPinToBitMask(enable_pin);
+
+  pinMode(rs_pin, OUTPUT);
+  pinMode(enable_pin, OUTPUT);
+
+  data_pins[0] = d4_pin;
+  data_pins[1] = d5_pin;
+  data_pins[2] = d6_pin;
+  data_pins[3] = d7_pin;
+
+// check if all data pins are connected to the same port and build the nibble lookup table
+  uint8_t port = digitalPinToPort(d4_pin);
+  data_mask = 0;
+  for(uint8_t i=0; i<4; i++) {
+    if(digitalPinToPort(data_pins[i]) != port) { port = NOT_A_PORT; }
+    data_mask |= digitalPinToBitMask(data_pins[i]);
+    pinMode(data_pins[i], OUTPUT);
+  }
+
+  if(port != NOT_A_PORT) {
+    data_port = portOutputRegister(port);
+    data_ddr = portModeRegister(port);
+    data_in = portInputRegister(port);
+    for(uint8_t n=0; n<16; n++) {
+      nibble_map[n] = 0;
+      for(uint8_t i=0; i<4; i++) {
+        if(n & (1<<i)) { nibble_map[n] |= digitalPinToBitMask(data_pins[i]); }
+      }
+    }
+  }
+  else { data_port = 0; }
+
+// the busy flag can only be read if all data pins are connected to the same port
+  rw_mask = 0;
+  if(rw_pin != HD44780_NO_RW && data_port) {
+    rw_port = portOutputRegister(digitalPinToPort(rw_pin));
+    rw_mask = digitalPinToBitMask(rw_pin);
+    pinMode(rw_pin, OUTPUT);
+  }
+
+  display_control = DISPLAY_CONTROL | DISPLAY_ON;
+  last_write = 0;
+  exec_time = 0;
+}
+
+//################################################################################################################
+//functions
+//################################################################################################################
+
+// initializes the LCD (4-bit mode, display on, cursor off, display cleared) for a given number of columns and
+// rows (1...4)
+void HD44780::begin(unsigned char cols, unsigned char rows) {
+  row_offset[0] = 0x00;
+  row_offset[1] = 0x40;
+  row_offset[2] = cols;
+  row_offset[3] = 0x40 + cols;
+
+  setPin(rs_port, rs_mask, 0);
+  setPin(en_port, en_mask, 0);
+  if(rw_mask) { setPin(rw_port, rw_mask, 0); }
+
+// wait for the power supply to settle (>40ms after Vcc rises to 2.7V)
+  delay(50);
+
+// software reset into 4-bit mode (datasheet figure 24); the busy flag can't be checked before it's finished,
+// so the fixed waiting times are used
+  writeNibble(FUNCTION_SET_8BIT);
+  delayMicroseconds(4500);
+  writeNibble(FUNCTION_SET_8BIT);
+  delayMicroseconds(150);
+  writeNibble(FUNCTION_SET_8BIT);
+  delayMicroseconds(EXEC_TIME);
+  writeNibble(FUNCTION_SET_4BIT);
+  delayMicroseconds(EXEC_TIME);
+  last_write = micros();
+  exec_time = EXEC_TIME;
+
+  command(FUNCTION_SET | ((rows > 1) ? TWO_LINES : 0), EXEC_TIME);
+  command(display_control, EXEC_TIME);
+  clear();
+  command(ENTRY_MODE_INCREMENT, EXEC_TIME);
+}
+
+//################################################################################################################
+
+// clears the display and sets the cursor to position 0/0
+void HD44780::clear() {
+  command(CLEAR_DISPLAY, EXEC_TIME_HOME);
+}
+
+//################################################################################################################
+
+// sets the cursor to position 0/0
+void HD44780::home() {
+  command(RETURN_HOME, EXEC_TIME_HOME);
+}
+
+//################################################################################################################
+
+// sets the cursor (i.e. the position the next character will be written to) to a given column and row
+void HD44780::setCursor(unsigned char col, unsigned char row) {
+  command(SET_DDRAM_ADDRESS | (row_offset[row & 3] + col), EXEC_TIME);
+}
+
+//################################################################################################################
+
+// writes a character to the current cursor position; the cursor will be incremented
+size_t HD44780::write(unsigned char value) {
+  send(value, 1, EXEC_TIME);
+  return 1;
+}
+
+//################################################################################################################
+
+// turn the display, the underline cursor and the blinking block cursor on or off
+void HD44780::display() {
+  display_control |= DISPLAY_ON;
+  command(display_control, EXEC_TIME);
+}
+
+void HD44780::noDisplay() {
+  display_control &= ~DISPLAY_ON;
+  command(display_control, EXEC_TIME);
+}
+
+void HD44780::cursor() {
+  display_control |= CURSOR_ON;
+  command(display_control, EXEC_TIME);
+}
+
+void HD44780::noCursor() {
+  display_control &= ~CURSOR_ON;
+  command(display_control, EXEC_TIME);
+}
+
+void HD44780::blink() {
+  display_control |= BLINK_ON;
+  command(display_control, EXEC_TIME);
+}
+
+void HD44780::noBlink() {
+  display_control &= ~BLINK_ON;
+  command(display_control, EXEC_TIME);
+}
+
+//################################################################################################################
+
+// returns true if the LCD has finished the last instruction, i.e. the next one will not have to wait
+boolean HD44780::ready() {
+  if(rw_mask) { return !readBusyFlag(); }
+  return (micros() - last_write) >= exec_time;
+}
+
+//################################################################################################################
+
+// sends an instruction
+void HD44780::command(uint8_t value, uint16_t duration) {
+  send(value, 0, duration);
+}
+
+//################################################################################################################
+
+// sends a byte (rs == 0 -> instruction; rs == 1 -> data) as two nibbles; the execution time of the previous
+// instruction is awaited before (not after) sending, so the caller only has to wait if the LCD is still busy
+void HD44780::send(uint8_t value, uint8_t rs, uint16_t duration) {
+  waitReady();
+  setPin(rs_port, rs_mask, rs);
+  writeNibble(value>>4);
+  writeNibble(value & 0x0F);
+  last_write = micros();
+  exec_time = duration;
+}
+
+//################################################################################################################
+
+// puts a nibble to D4...D7 (with one port operation, if possible) and clocks it into the LCD
+void HD44780::writeNibble(uint8_t nibble) {
+  if(data_port) {
+    uint8_t sreg = SREG;
+    cli(); // the port might be shared with pins written by interrupt routines
+    *data_port = (*data_port & ~data_mask) | nibble_map[nibble];
+    SREG = sreg;
+  }
+  else {
+    for(uint8_t i=0; i<4; i++) {
+      digitalWrite(data_pins[i], (nibble>>i) & 1);
+    }
+  }
+  pulseEnable();
+}
+
+//################################################################################################################
+
+// waits until the LCD has finished the last instruction
+void HD44780::waitReady() {
+  if(rw_mask) {
+    while(readBusyFlag());
+  }
+  else {
+    while((micros() - last_write) < exec_time);
+  }
+}
+
+//################################################################################################################
+
+// reads the busy flag (D7 of the high nibble; the address counter in the remaining bits is discarded)
+uint8_t HD44780::readBusyFlag() {
+  uint8_t busy;
+  uint8_t sreg = SREG;
+
+// switch the data pins to input (pull-ups off)
+  cli();
+  *data_ddr &= ~data_mask;
+  *data_port &= ~data_mask;
+  SREG = sreg;
+
+  setPin(rs_port, rs_mask, 0);
+  setPin(rw_port, rw_mask, 1);
+
+  setPin(en_port, en_mask, 1);
+  HD44780_DELAY_500NS(); // data delay time (max. 360ns)
+  busy = *data_in & nibble_map[8];
+  setPin(en_port, en_mask, 0);
+  HD44780_DELAY_500NS();
+  pulseEnable(); // low nibble
+
+  setPin(rw_port, rw_mask, 0);
+  cli();
+  *data_ddr |= data_mask;
+  SREG = sreg;
+
+  return busy;
+}
+
+//################################################################################################################
+
+inline void HD44780::setPin(volatile uint8_t *port, uint8_t mask, uint8_t value) {
+  uint8_t sreg = SREG;
+  cli();
+  if(value) { *port |= mask; }
+  else { *port &= ~mask; }
+  SREG = sreg;
+}
+
+//################################################################################################################
+
+inline void HD44780::pulseEnable() {
+  setPin(en_port, en_mask, 1);
+  HD44780_DELAY_500NS();
+  setPin(en_port, en_mask, 0);
+  HD44780_DELAY_500NS();
+}
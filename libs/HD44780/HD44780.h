@@ -0,0 +1,96 @@
+/*
+  "HD44780"
+  library driving HD44780-compatible character LCDs in 4-bit mode by direct port access
+  V1.0 / Copyright (C) 2017, T.Rode (DL1DUZ)
+
+  Permission is granted to use, copy, modify, and distribute this software
+  and documentation for non-commercial purposes.
+
+  Required ressources:
+   - 6 digital output pins (RS, E, D4...D7), optionally 1 more for R/W (busy-flag mode)
+   - D4...D7 should be connected to the same port (any bit order) so that each nibble can be written with one
+     port operation; otherwise slow "digitalWrite" calls will be used and the busy-flag mode is not available
+*/
+
+#ifndef HD44780_h_
+#define HD44780_h_
+
+#if (ARDUINO >= 100)
+#include <Arduino.h>
+#else
+#include <WProgram.h>
+#endif
+
+#include <stdint.h>
+
+//################################################################################################################
+//definitions
+//################################################################################################################
+
+// pin value indicating that R/W is not connected (tied to GND); the execution times will then be met by timing
+const uint8_t HD44780_NO_RW = 0xFF;
+
+class HD44780 {
+
+public:
+// constructor
+  HD44780(unsigned char RS_PIN, unsigned char ENABLE_PIN, unsigned char D4_PIN, unsigned char D5_PIN,
+          unsigned char D6_PIN, unsigned char D7_PIN, unsigned char RW_PIN = HD44780_NO_RW);
+// destructor
+  ~HD44780() { }
+
+// initializes the LCD (4-bit mode, display on, cursor off, display cleared) for a given number of columns and
+// rows (1...4)
+  void begin(unsigned char cols, unsigned char rows);
+// clears the display and sets the cursor to position 0/0
+  void clear();
+// sets the cursor to position 0/0
+  void home();
+// sets the cursor (i.e. the position the next character will be written to) to a given column and row
+  void setCursor(unsigned char col, unsigned char row);
+// writes a character to the current cursor position; the cursor will be incremented
+  size_t write(unsigned char value);
+// turn the display, the underline cursor and the blinking block cursor on or off
+  void display();
+  void noDisplay();
+  void cursor();
+  void noCursor();
+  void blink();
+  void noBlink();
+// returns true if the LCD has finished the last instruction, i.e. the next one will not have to wait
+  boolean ready();
+
+private:
+// ports and bit masks of the control lines and data lines
+  volatile uint8_t *rs_port;
+  volatile uint8_t *en_port;
+  volatile uint8_t *rw_port;
+  volatile uint8_t *data_port;
+  volatile uint8_t *data_ddr;
+  volatile uint8_t *data_in;
+  uint8_t rs_mask;
+  uint8_t en_mask;
+  uint8_t rw_mask;
+  uint8_t data_mask;
+// the data pins (only used, if D4...D7 are not connected to the same port)
+  uint8_t data_pins[4];
+// the port bits representing each possible nibble
+  uint8_t nibble_map[16];
+// DDRAM address of the first character in each row
+  uint8_t row_offset[4];
+// the current "display on/off control" instruction (display, cursor and blink flags)
+  uint8_t display_control;
+// timestamp [µs] and execution time [µs] of the last instruction (only used without R/W)
+  uint32_t last_write;
+  uint16_t exec_time;
+
+  void command(uint8_t value, uint16_t duration);
+  void send(uint8_t value, uint8_t rs, uint16_t duration);
+  void writeNibble(uint8_t nibble);
+  void waitReady();
+  uint8_t readBusyFlag();
+  inline void setPin(volatile uint8_t *port, uint8_t mask, uint8_t value);
+  inline void pulseEnable();
+};
+
+#endif // HD44780_h_
@@ -0,0 +1,81 @@
+/*
+  "NumberFormat"
+  library providing division-free formatting of integers for character displays
+  V1.0 / Copyright (C) 2017, T.Rode (DL1DUZ)
+
+  Permission is granted to use, copy, modify, and distribute this software
+  and documentation for non-commercial purposes.
+
+  AVR-MCUs have no hardware divider; divisions by constants are therefore replaced by multiplications with
+  the reciprocal and the last two digits are taken from a lookup table in PROGMEM (200 bytes).
+*/
+
+//################################################################################################################
+//includes
+//################################################################################################################
+
+#include <NumberFormat.h>
+
+//################################################################################################################
+//declarations
+//################################################################################################################
+
+// the characters of all two-digit numbers 00...99
+const char DIGIT_PAIRS[201] PROGMEM =
+  "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+  "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+//################################################################################################################
+//functions
+//################################################################################################################
+
+// formats a number right-aligned into a field of 5 characters (text[0...4]); the number of leading zeros can be
+// specified spanning from 0 to 3; the max. number of digits can be specified spanning from 1 to 4; neg. values
+// will be preceeded by "-"; returns the index of the first character of the result (text[0...index-1] is not
+// part of it); values beyond 4 digits will show n/1000 as a character offset from '0' at the thousands position
+uint8_t NumberFormatClass::format(int16_t number, char *text, uint8_t leading_zeros, uint8_t max_digits) {
+  uint16_t n = number;
+  if(number < 0) { n = -n; }
+
+// split into thousands, hundreds and the last two digits
+  uint16_t hundreds = div100(n);
+  uint8_t last = n - hundreds*100;
+  uint8_t th = (uint32_t(hundreds)*205)>>11; // hundreds/10 (exact for 0...1028; 32 bit, as 327*205 exceeds uint16)
+  uint8_t h = hundreds - th*10;
+
+  text[1] = '0' + th;
+  text[2] = '0' + h;
+  text[3] = pgm_read_byte_near(DIGIT_PAIRS + 2*last);
+  text[4] = pgm_read_byte_near(DIGIT_PAIRS + 2*last + 1);
+
+// the start position is set by the first non-zero digit (the last digit is always displayed), the leading zeros
+// and the max. number of digits
+  int8_t sp = th ? 1 : (h ? 2 : (last > 9 ? 3 : 4));
+  sp -= leading_zeros;
+  if(sp < 1) { sp = 1; }
+
+  uint8_t ssize = 5 - max_digits;
+  if(ssize > sp) { sp = ssize; }
+
+  if(number < 0) {
+    sp--;
+    text[sp] = '-';
+  }
+
+  return sp;
+}
+
+//################################################################################################################
+
+// writes a fixed-point value given in tenths (0...99, larger values are limited to 99) as "x.y" to text[0...2]
+void NumberFormatClass::formatTenths(uint8_t tenths, char *text) {
+  if(tenths > 99) { tenths = 99; }
+  text[0] = pgm_read_byte_near(DIGIT_PAIRS + 2*tenths);
+  text[1] = '.';
+  text[2] = pgm_read_byte_near(DIGIT_PAIRS + 2*tenths + 1);
+}
+
+//################################################################################################################
+
+NumberFormatClass NF;
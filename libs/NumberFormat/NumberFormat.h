@@ -0,0 +1,46 @@
+/*
+  "NumberFormat"
+  library providing division-free formatting of integers for character displays
+  V1.0 / Copyright (C) 2017, T.Rode (DL1DUZ)
+
+  Permission is granted to use, copy, modify, and distribute this software
+  and documentation for non-commercial purposes.
+
+  AVR-MCUs have no hardware divider; divisions by constants are therefore replaced by multiplications with
+  the reciprocal and the last two digits are taken from a lookup table in PROGMEM (200 bytes).
+*/
+
+#ifndef NumberFormat_h_
+#define NumberFormat_h_
+
+#if (ARDUINO >= 100)
+#include <Arduino.h>
+#else
+#include <WProgram.h>
+#endif
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+//################################################################################################################
+//definitions
+//################################################################################################################
+
+class NumberFormatClass {
+
+public:
+// formats a number right-aligned into a field of 5 characters (text[0...4]); the number of leading zeros can be
+// specified spanning from 0 to 3; the max. number of digits can be specified spanning from 1 to 4; neg. values
+// will be preceeded by "-"; returns the index of the first character of the result (text[0...index-1] is not
+// part of it); values beyond 4 digits will show n/1000 as a character offset from '0' at the thousands position
+  uint8_t format(int16_t number, char *text, uint8_t leading_zeros, uint8_t max_digits);
+// writes a fixed-point value given in tenths (0...99, larger values are limited to 99) as "x.y" to text[0...2]
+  void formatTenths(uint8_t tenths, char *text);
+// divides by 10 / 100 by multiplication with the reciprocal (exact for 0...65535)
+  inline uint16_t div10(uint16_t n) { return (uint32_t(n)*0xCCCD)>>19; }
+  inline uint16_t div100(uint16_t n) { return (uint32_t(n>>2)*5243)>>17; }
+};
+
+extern NumberFormatClass NF;
+
+#endif // NumberFormat_h_
@@ -0,0 +1,194 @@
+/*
+  "SWRStats"
+  library keeping per-band SWR statistics (running sum, min/max, EWMA and a coarse histogram) and saving them to
+  a wear-levelled ring of EEPROM snapshots
+  V1.0 / Copyright (C) 2017, T.Rode (DL1DUZ)
+
+  Permission is granted to use, copy, modify, and distribute this software
+  and documentation for non-commercial purposes.
+
+  Requires library "CRC8"
+*/
+
+//################################################################################################################
+//includes
+//################################################################################################################
+
+#include <SWRStats.h>
+
+//################################################################################################################
+//declarations
+//################################################################################################################
+
+// a snapshot consists of a header (CRC, sequence number low/high byte) and the statistics of all bands; it is
+// written data first and sequence number last, so that an interrupted save never leaves a valid snapshot
+const uint8_t HEADER_SIZE = 3;
+const uint8_t DATA_SIZE = SWR_STATS_BANDS*sizeof(swr_band_stats);
+const uint8_t SLOT_SIZE = HEADER_SIZE + DATA_SIZE;
+
+// the number of values, at which sum, count and histogram are halved (keeps the sum within 32 bits)
+const uint32_t MAX_COUNT = 0x1000000;
+// the EWMA's weight of a new value is 2^-EWMA_SHIFT (a time constant of some 40s at one value per 2.3ms)
+const uint8_t EWMA_SHIFT = 14;
+// the lower limits of histogram bins 1...3 (10x the SWR)
+const uint8_t BIN_LIMIT[SWR_STATS_BINS - 1] = {15, 20, 31};
+// sequence number of an erased slot
+const uint16_t ERASED = 0xFFFF;
+
+//################################################################################################################
+//functions
+//################################################################################################################
+
+// loads the newest valid snapshot from a ring of "slots" snapshots starting at "eeprom_address" (the statistics
+// are cleared, if there is none); returns the next free address in EEPROM
+uint16_t SWRStatsClass::init(uint16_t eeprom_address, uint8_t slots) {
+  eeprom_start = eeprom_address;
+  slot_count = slots;
+  save_pos = 0;
+  next_slot = 0;
+  next_seq = 0;
+
+  uint8_t found = 0;
+  uint8_t newest_slot = 0;
+  for(uint8_t s=0; s<slot_count; s++) {
+    uint16_t address = slotAddress(s);
+    uint16_t seq = EEPROM.read(address + 1) | (EEPROM.read(address + 2) << 8);
+    if(seq == ERASED) { continue; }
+
+    for(uint8_t i=0; i<DATA_SIZE; i++) {
+      ((uint8_t*) stats)[i] = EEPROM.read(address + HEADER_SIZE + i);
+    }
+    if(EEPROM.read(address) == CRC.crcCalculation(uint8_t(seq), (uint8_t*) stats, DATA_SIZE) &&
+       (!found || int16_t(seq - next_seq) >= 0)) {
+      found = 1;
+      newest_slot = s;
+      next_seq = seq + 1;
+    }
+  }
+
+  if(found) {
+    for(uint8_t i=0; i<DATA_SIZE; i++) {
+      ((uint8_t*) stats)[i] = EEPROM.read(slotAddress(newest_slot) + HEADER_SIZE + i);
+    }
+    next_slot = (newest_slot == slot_count - 1) ? 0 : newest_slot + 1;
+    if(next_seq == ERASED) { next_seq = 0; }
+  }
+  else { clear(); }
+
+  return eeprom_start + slot_count*SLOT_SIZE;
+}
+
+//################################################################################################################
+
+// adds an SWR value (10x the SWR) to the statistics of a band in constant time
+void SWRStatsClass::record(uint8_t band, uint8_t swr) {
+  swr_band_stats *s = stats + band;
+
+  if(s->count == MAX_COUNT) {
+    s->sum >>= 1;
+    s->count >>= 1;
+  }
+
+  if(s->count) { s->ewma += (int32_t(uint32_t(swr) << 16) - int32_t(s->ewma)) >> EWMA_SHIFT; }
+  else { s->ewma = uint32_t(swr) << 16; }
+
+  s->sum += swr;
+  s->count++;
+  if(swr < s->min) { s->min = swr; }
+  if(swr > s->max) { s->max = swr; }
+
+  uint8_t bin = 0;
+  while(bin < SWR_STATS_BINS - 1 && swr >= BIN_LIMIT[bin]) { bin++; }
+  if(++s->hist[bin] == 0xFFFF) {
+    for(uint8_t i=0; i<SWR_STATS_BINS; i++) { s->hist[i] >>= 1; }
+  }
+
+// the snapshot being saved is outdated now
+  save_pos = 0;
+}
+
+//################################################################################################################
+
+// writes the statistics to the next slot of the ring, one byte per call at most (an EEPROM write takes 3.3ms,
+// so the caller is never blocked); returns 1 when the snapshot is complete; recording a value during a save
+// restarts it
+uint8_t SWRStatsClass::save() {
+  if(!slot_count) { return 1; }
+  if(!eeprom_is_ready()) { return 0; }
+
+  if(!save_pos) { save_crc = CRC.crcCalculation(uint8_t(next_seq), (uint8_t*) stats, DATA_SIZE); }
+
+// bytes already holding the right value are skipped (wear levelling within the slot)
+  while(save_pos < SLOT_SIZE) {
+    uint8_t pos = (save_pos < DATA_SIZE) ? save_pos + HEADER_SIZE : save_pos - DATA_SIZE;
+    uint16_t address = slotAddress(next_slot) + pos;
+    uint8_t value = snapshotByte(pos);
+    save_pos++;
+    if(EEPROM.read(address) != value) {
+      EEPROM.write(address, value);
+      return 0;
+    }
+  }
+
+  save_pos = 0;
+  next_slot = (next_slot == slot_count - 1) ? 0 : next_slot + 1;
+  if(++next_seq == ERASED) { next_seq = 0; }
+  return 1;
+}
+
+//################################################################################################################
+
+// prints the statistics in a compact, comma separated format (a header "SWRSTATS,<snapshot no.>,<bands>" and
+// one line "<band>,<count>,<mean>,<min>,<max>,<ewma>,<bin 0>,...,<bin 3>" per band)
+void SWRStatsClass::dump(Print &out) {
+  out.print(F("SWRSTATS,")); out.print(next_seq); out.print(','); out.println(SWR_STATS_BANDS);
+
+  for(uint8_t b=0; b<SWR_STATS_BANDS; b++) {
+    swr_band_stats *s = stats + b;
+    out.print(b); out.print(',');
+    out.print(s->count); out.print(',');
+    out.print(s->count ? s->sum/s->count : 0); out.print(',');
+    out.print(s->count ? s->min : 0); out.print(',');
+    out.print(s->max); out.print(',');
+    out.print((s->ewma + 0x8000) >> 16);
+    for(uint8_t i=0; i<SWR_STATS_BINS; i++) {
+      out.print(','); out.print(s->hist[i]);
+    }
+    out.println();
+  }
+}
+
+//################################################################################################################
+
+void SWRStatsClass::clear() {
+  for(uint8_t b=0; b<SWR_STATS_BANDS; b++) {
+    stats[b].sum = 0;
+    stats[b].count = 0;
+    stats[b].min = 0xFF;
+    stats[b].max = 0;
+    stats[b].ewma = 0;
+    for(uint8_t i=0; i<SWR_STATS_BINS; i++) { stats[b].hist[i] = 0; }
+  }
+}
+
+//################################################################################################################
+
+uint16_t SWRStatsClass::slotAddress(uint8_t slot) {
+  return eeprom_start + slot*SLOT_SIZE;
+}
+
+//################################################################################################################
+
+// returns the byte at position "pos" of the snapshot being saved
+uint8_t SWRStatsClass::snapshotByte(uint8_t pos) {
+  switch(pos) {
+    case 0: return save_crc;
+    case 1: return next_seq & 0xFF;
+    case 2: return next_seq >> 8;
+  }
+  return ((uint8_t*) stats)[pos - HEADER_SIZE];
+}
+
+//################################################################################################################
+
+SWRStatsClass SWRStats;
@@ -0,0 +1,81 @@
+/*
+  "SWRStats"
+  library keeping per-band SWR statistics (running sum, min/max, EWMA and a coarse histogram) and saving them to
+  a wear-levelled ring of EEPROM snapshots
+  V1.0 / Copyright (C) 2017, T.Rode (DL1DUZ)
+
+  Permission is granted to use, copy, modify, and distribute this software
+  and documentation for non-commercial purposes.
+
+  Requires library "CRC8"
+*/
+
+#ifndef SWRStats_h_
+#define SWRStats_h_
+
+#if (ARDUINO >= 100)
+#include <Arduino.h>
+#else
+#include <WProgram.h>
+#endif
+
+#include <stdint.h>
+#include <EEPROM.h>
+#include <avr/eeprom.h>
+#include <CRC8.h>
+
+//################################################################################################################
+//definitions
+//################################################################################################################
+
+// the number of bands (160-10m) and histogram bins (SWR 1.0-1.4, 1.5-1.9, 2.0-3.0, >3.0)
+const uint8_t SWR_STATS_BANDS = 10;
+const uint8_t SWR_STATS_BINS = 4;
+
+// statistics of one band; all SWR values are given as 10x the SWR
+struct swr_band_stats {
+  uint32_t sum;    // sum of all values (sum and count are halved when count reaches 2^24)
+  uint32_t count;  // number of values
+  uint8_t min;
+  uint8_t max;
+  uint32_t ewma;   // exponentially weighted moving average [Q16]
+  uint16_t hist[SWR_STATS_BINS]; // (all bins are halved when one of them reaches 0xFFFF)
+};
+
+class SWRStatsClass {
+
+public:
+// loads the newest valid snapshot from a ring of "slots" snapshots starting at "eeprom_address" (the statistics
+// are cleared, if there is none); returns the next free address in EEPROM
+  uint16_t init(uint16_t eeprom_address, uint8_t slots);
+// adds an SWR value (10x the SWR) to the statistics of a band in constant time
+  void record(uint8_t band, uint8_t swr);
+// writes the statistics to the next slot of the ring, one byte per call at most (an EEPROM write takes 3.3ms,
+// so the caller is never blocked); returns 1 when the snapshot is complete; recording a value during a save
+// restarts it
+  uint8_t save();
+// returns the statistics of a band
+  const swr_band_stats* getStats(uint8_t band) { return stats + band; }
+// prints the statistics in a compact, comma separated format (a header "SWRSTATS,<snapshot no.>,<bands>" and
+// one line "<band>,<count>,<mean>,<min>,<max>,<ewma>,<bin 0>,...,<bin 3>" per band)
+  void dump(Print &out);
+
+private:
+  swr_band_stats stats[SWR_STATS_BANDS];
+// EEPROM start address and number of slots of the ring, the slot to be written next and its sequence number
+  uint16_t eeprom_start;
+  uint8_t slot_count;
+  uint8_t next_slot;
+  uint16_t next_seq;
+// state of the save in progress (position within the slot, 0 == no save in progress) and the snapshot's CRC
+  uint8_t save_pos;
+  uint8_t save_crc;
+
+  void clear();
+  uint16_t slotAddress(uint8_t slot);
+  uint8_t snapshotByte(uint8_t pos);
+};
+
+extern SWRStatsClass SWRStats;
+
+#endif // SWRStats_h_
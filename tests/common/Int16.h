@@ -0,0 +1,165 @@
+/*
+ Int16.h (host builds only, see tests/Readme.txt)
+
+ The integer arithmetic of avr-gcc on the host: "int" has 16 bit on the AVR, so operands of up to 16 bit are
+ promoted to int16_t (uint16_t if one of them is an unsigned 16 bit value) and the results of +, -, *, << wrap
+ at 16 bit, whereas the host computes them with 32 bit and such overflows go unnoticed. avr16::Int<T> holds a
+ value of type T and does its arithmetic the way the target does; code compiled with its integer types replaced
+ by it (see unit/NumberFormat_int16.cpp) computes what the target computes.
+
+ Operands of other types: "int" (the type of the literals) counts as 16 bit, like on the target; 32 bit and
+ wider ones (uint32_t(...) casts, unsigned and long literals) and floating point keep the host's arithmetic, as
+ they would on the target (wider than "int" there, too).
+*/
+
+#ifndef INT16_H_
+#define INT16_H_
+
+#include <stdint.h>
+#include <type_traits>
+
+namespace avr16 {
+
+template<class T> class Int;
+
+// the type an operand of type T is promoted to on the target (void: not a 16 bit type, host arithmetic)
+template<class T> struct promoted {
+  typedef typename std::conditional<sizeof(T) < 2 || std::is_same<T, int>::value, int16_t,
+          typename std::conditional<sizeof(T) == 2 && !std::is_floating_point<T>::value,
+          typename std::conditional<std::is_signed<T>::value, int16_t, uint16_t>::type, void>::type>::type type;
+};
+
+// the common type P of two operands and the type W the host computes in (wide enough not to overflow; the result
+// is truncated to P); "type" is the result of an arithmetic operation
+template<class A, class B, bool HOST = std::is_void<typename promoted<A>::type>::value ||
+                                       std::is_void<typename promoted<B>::type>::value>
+struct arithmetic {
+  typedef typename std::conditional<std::is_same<typename promoted<A>::type, uint16_t>::value ||
+                                    std::is_same<typename promoted<B>::type, uint16_t>::value,
+                                    uint16_t, int16_t>::type P;
+  typedef int64_t W;
+  typedef Int<P> type;
+};
+
+template<class A, class B> struct arithmetic<A, B, true> {
+  typedef decltype(A() + B()) P;
+  typedef P W;
+  typedef P type;
+};
+
+// shifts: the result has the type of the promoted left operand
+template<class A, bool HOST = std::is_void<typename promoted<A>::type>::value> struct shift {
+  typedef typename promoted<A>::type P;
+  typedef int64_t W;
+  typedef Int<P> type;
+};
+
+template<class A> struct shift<A, true> {
+  typedef decltype(+A()) P;
+  typedef P W;
+  typedef P type;
+};
+
+template<class T> class Int {
+  T v;
+
+public:
+  Int() {}
+  template<class U, class = typename std::enable_if<std::is_arithmetic<U>::value>::type> Int(U u) : v(T(u)) {}
+  template<class U> Int(Int<U> u) : v(T(U(u))) {}
+
+  operator T() const { return v; }
+
+  template<class U> Int &operator+=(U u) { return *this = *this + u; }
+  template<class U> Int &operator-=(U u) { return *this = *this - u; }
+  template<class U> Int &operator*=(U u) { return *this = *this * u; }
+  template<class U> Int &operator/=(U u) { return *this = *this / u; }
+  template<class U> Int &operator%=(U u) { return *this = *this % u; }
+  template<class U> Int &operator&=(U u) { return *this = *this & u; }
+  template<class U> Int &operator|=(U u) { return *this = *this | u; }
+  template<class U> Int &operator^=(U u) { return *this = *this ^ u; }
+  template<class U> Int &operator<<=(U u) { return *this = *this << u; }
+  template<class U> Int &operator>>=(U u) { return *this = *this >> u; }
+
+  Int &operator++() { return *this += 1; }
+  Int &operator--() { return *this -= 1; }
+  Int operator++(int) { Int r = *this; *this += 1; return r; }
+  Int operator--(int) { Int r = *this; *this -= 1; return r; }
+};
+
+// R, if B is a built-in arithmetic type (the operators for Int op B)
+template<class B, class R> using if_arithmetic = typename std::enable_if<std::is_arithmetic<B>::value, R>::type;
+
+// +, -, *, /, %, &, |, ^ (for Int op Int, Int op built-in type and built-in type op Int)
+#define AVR16_ARITHMETIC(OP) \
+  template<class A, class B> typename arithmetic<A, B>::type operator OP(Int<A> a, Int<B> b) { \
+    typedef arithmetic<A, B> C; \
+    return typename C::type(typename C::W(typename C::P(A(a))) OP typename C::W(typename C::P(B(b)))); \
+  } \
+  template<class A, class B> if_arithmetic<B, typename arithmetic<A, B>::type> operator OP(Int<A> a, B b) { \
+    typedef arithmetic<A, B> C; \
+    return typename C::type(typename C::W(typename C::P(A(a))) OP typename C::W(typename C::P(b))); \
+  } \
+  template<class A, class B> if_arithmetic<B, typename arithmetic<B, A>::type> operator OP(B b, Int<A> a) { \
+    typedef arithmetic<B, A> C; \
+    return typename C::type(typename C::W(typename C::P(b)) OP typename C::W(typename C::P(A(a)))); \
+  }
+
+// comparisons (in the common type, e.g. unsigned if one operand is uint16_t)
+#define AVR16_COMPARISON(OP) \
+  template<class A, class B> bool operator OP(Int<A> a, Int<B> b) { \
+    typedef arithmetic<A, B> C; \
+    return typename C::W(typename C::P(A(a))) OP typename C::W(typename C::P(B(b))); \
+  } \
+  template<class A, class B> if_arithmetic<B, bool> operator OP(Int<A> a, B b) { \
+    typedef arithmetic<A, B> C; \
+    return typename C::W(typename C::P(A(a))) OP typename C::W(typename C::P(b)); \
+  } \
+  template<class A, class B> if_arithmetic<B, bool> operator OP(B b, Int<A> a) { \
+    typedef arithmetic<B, A> C; \
+    return typename C::W(typename C::P(b)) OP typename C::W(typename C::P(A(a))); \
+  }
+
+#define AVR16_SHIFT(OP) \
+  template<class A, class B> typename shift<A>::type operator OP(Int<A> a, Int<B> b) { \
+    typedef shift<A> C; \
+    return typename C::type(typename C::W(typename C::P(A(a))) OP int(B(b))); \
+  } \
+  template<class A, class B> if_arithmetic<B, typename shift<A>::type> operator OP(Int<A> a, B b) { \
+    typedef shift<A> C; \
+    return typename C::type(typename C::W(typename C::P(A(a))) OP int(b)); \
+  } \
+  template<class A, class B> if_arithmetic<B, typename shift<B>::type> operator OP(B b, Int<A> a) { \
+    typedef shift<B> C; \
+    return typename C::type(typename C::W(typename C::P(b)) OP int(A(a))); \
+  }
+
+AVR16_ARITHMETIC(+)
+AVR16_ARITHMETIC(-)
+AVR16_ARITHMETIC(*)
+AVR16_ARITHMETIC(/)
+AVR16_ARITHMETIC(%)
+AVR16_ARITHMETIC(&)
+AVR16_ARITHMETIC(|)
+AVR16_ARITHMETIC(^)
+AVR16_COMPARISON(==)
+AVR16_COMPARISON(!=)
+AVR16_COMPARISON(<)
+AVR16_COMPARISON(<=)
+AVR16_COMPARISON(>)
+AVR16_COMPARISON(>=)
+AVR16_SHIFT(<<)
+AVR16_SHIFT(>>)
+
+#undef AVR16_ARITHMETIC
+#undef AVR16_COMPARISON
+#undef AVR16_SHIFT
+
+// unary operators (promotion as for "0 op a")
+template<class A> auto operator+(Int<A> a) -> decltype(0 + a) { return 0 + a; }
+template<class A> auto operator-(Int<A> a) -> decltype(0 - a) { return 0 - a; }
+template<class A> auto operator~(Int<A> a) -> decltype(a ^ -1) { return a ^ -1; }
+
+} // namespace avr16
+
+#endif // INT16_H_
@@ -0,0 +1,147 @@
+/*
+ ManchesterEncoder.h (host builds only, see tests/Readme.txt)
+
+ A reference transmitter for the receiver tests: the state machine of DataTransmitterClass::isr (GPS/libs/
+ DataTransmitter) step by step, i.e. the pin levels the GPS-module outputs at its timer 2 compare matches,
+ including preamble, sync bits, ID, CRC, optional forward error correction and the tail. Any change of the
+ transmitter's isr has to be made here as well.
+
+ Requires libraries "CRC8" and "HammingFEC".
+*/
+
+#ifndef MANCHESTER_ENCODER_H_
+#define MANCHESTER_ENCODER_H_
+
+#include <stdint.h>
+#include <CRC8.h>
+#include <HammingFEC.h>
+
+class ManchesterEncoder {
+
+public:
+  // the CPU cycles (16MHz) between two steps, as set up by DataTransmitterClass::init for the given byte rate
+  static uint32_t stepCycles(uint8_t byte_rate) {
+    static const uint8_t PRE[7] = {0, 3, 2, 1, 1, 1, 2};
+    static const uint16_t PRESCALER[8] = {0, 1, 8, 32, 64, 128, 256, 1024};
+    uint8_t i = 0;
+    uint32_t multiplier = 1000000/((byte_rate > 4) ? byte_rate : 4);
+    do {
+      multiplier >>= PRE[i];
+      ++i;
+    }
+    while(multiplier > 0x100);
+
+    return multiplier*PRESCALER[i];
+  }
+
+  // starts the transmission of a dataset (as DataTransmitterClass::transmitData); returns 0 if busy or invalid
+  uint8_t start(uint8_t id, const uint8_t *data, uint8_t size) {
+    if(bytes || !size || ((id & FEC_FLAG) && size > FEC_MAX_SIZE)) { return 0; }
+
+    fec = id & FEC_FLAG;
+    this->size = size;
+    this->data = data;
+    crc = CRC.crcCalculation(id, data, size);
+    if(fec) {
+      bytes = fecEncodedSize(size);
+      curr_byte = id;
+      block_size = 23;
+    }
+    else {
+      bytes = size;
+      curr_byte = crc;
+      curr_byte <<= 8;
+      curr_byte += id;
+      block_size = 39;
+    }
+    curr_byte <<= 2;
+    curr_byte += 3;
+
+    step_counter = 1;
+    prev_symbol = 0;
+    byte_counter = 0;
+    pin_value = 1;
+    running = 1;
+
+    return 1;
+  }
+
+  // executes one step (a compare match of timer 2) and returns the new pin level
+  uint8_t step() {
+    if(step_counter < 4) {
+      pin_value = !pin_value;
+    }
+    else {
+      if(!(step_counter & 1)) {
+        curr_symbol = curr_byte & 1;
+        curr_byte >>= 1;
+        if(prev_symbol^curr_symbol) {
+          pin_value = !pin_value;
+        }
+        prev_symbol = curr_symbol;
+      }
+
+      if(step_counter == block_size) {
+        step_counter = 3;
+        if(byte_counter == bytes) {
+          if(block_size == 4) {
+            running = 0;
+            bytes = 0;
+          }
+          else {
+            curr_byte = 0;
+            block_size = 4;
+          }
+        }
+        else {
+          curr_byte = fec ? nextFECByte() : data[byte_counter];
+          block_size = 19;
+          ++byte_counter;
+        }
+      }
+    }
+
+    ++step_counter;
+    pin_value = !pin_value;
+
+    return pin_value;
+  }
+
+  // 1 while steps are due (the transmitter stops its timer with the last step)
+  uint8_t busy() const { return running; }
+  uint8_t level() const { return pin_value; }
+
+private:
+  uint8_t nextFECByte() {
+    uint8_t i = byte_counter & 7;
+
+    if(!i) {
+      uint8_t in[4];
+      uint8_t pos = byte_counter >> 1;
+      for(uint8_t j=0; j<4; ++j, ++pos) {
+        if(!pos) { in[j] = crc; }
+        else { in[j] = (pos <= size) ? data[pos - 1] : 0; }
+      }
+      FEC.encodeBlock(in, fec_block);
+    }
+
+    return fec_block[i];
+  }
+
+  const uint8_t *data = 0;
+  uint8_t bytes = 0;
+  uint16_t byte_counter = 0;
+  uint8_t step_counter = 0;
+  uint8_t prev_symbol = 0;
+  uint8_t curr_symbol = 0;
+  uint32_t curr_byte = 0;
+  uint8_t block_size = 0;
+  uint8_t pin_value = 0;
+  uint8_t running = 0;
+  uint8_t fec = 0;
+  uint8_t size = 0;
+  uint8_t crc = 0;
+  uint8_t fec_block[8];
+};
+
+#endif // MANCHESTER_ENCODER_H_
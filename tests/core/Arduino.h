@@ -0,0 +1,148 @@
+/*
+ Arduino.h of the simulated Arduino core (host builds only, see tests/Readme.txt)
+
+ The subset of the Arduino AVR core (1.8.x) used by the sketch and its libraries, for an ATmega328P @16MHz with
+ the pin mapping of the Arduino Uno/Nano. All functions run on the simulation's virtual clock (SimCore.h); each
+ call is charged with the approximate number of CPU cycles it takes on the target.
+
+ Differences to the target that remain: "int" has 32 bit and "long" 64 bit on the host (micros() and millis()
+ return values wrapping at 32 bit nevertheless), code outside the core functions takes no time.
+*/
+
+#ifndef SIM_ARDUINO_H_
+#define SIM_ARDUINO_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef unsigned int word;
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define DEFAULT 1
+#define EXTERNAL 0
+#define INTERNAL 3
+
+#define LSBFIRST 0
+#define MSBFIRST 1
+
+#define F_CPU 16000000UL
+#define clockCyclesPerMicrosecond() (F_CPU / 1000000L)
+
+#define A0 14
+#define A1 15
+#define A2 16
+#define A3 17
+#define A4 18
+#define A5 19
+#define A6 20
+#define A7 21
+#define LED_BUILTIN 13
+#define NUM_DIGITAL_PINS 20
+
+#define NOT_A_PIN 0
+#define NOT_A_PORT 0
+#define PB 2
+#define PC 3
+#define PD 4
+#define NOT_AN_INTERRUPT -1
+#define NOT_ON_TIMER 0
+#define TIMER0A 1
+#define TIMER0B 2
+#define TIMER1A 3
+#define TIMER1B 4
+#define TIMER2A 7
+#define TIMER2B 8
+
+// the same semantics as the macros of the AVR core (the result has the common type of both arguments)
+template<class T, class L> inline auto min(const T &a, const L &b) -> decltype((b < a) ? b : a) {
+  return (b < a) ? b : a;
+}
+template<class T, class L> inline auto max(const T &a, const L &b) -> decltype((b < a) ? b : a) {
+  return (a < b) ? b : a;
+}
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define sq(x) ((x)*(x))
+
+#define lowByte(w) ((uint8_t) ((w) & 0xff))
+#define highByte(w) ((uint8_t) ((w) >> 8))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitWrite(value, bit, bitvalue) ((bitvalue) ? bitSet(value, bit) : bitClear(value, bit))
+#define bit(b) (1UL << (b))
+
+#define interrupts() sei()
+#define noInterrupts() cli()
+
+//################################################################################################################
+// pin mapping (Arduino Uno/Nano: D0...D7 -> PORTD, D8...D13 -> PORTB, A0...A5 -> PORTC)
+//################################################################################################################
+
+#define digitalPinToPort(P) ((uint8_t) ((P) < 8 ? PD : ((P) < 14 ? PB : ((P) < 20 ? PC : NOT_A_PORT))))
+#define digitalPinToBitMask(P) ((uint8_t) (1 << ((P) < 8 ? (P) : ((P) < 14 ? (P) - 8 : (P) - 14))))
+#define digitalPinToTimer(P) ((P) == 3 ? TIMER2B : ((P) == 11 ? TIMER2A : ((P) == 5 ? TIMER0B : \
+                              ((P) == 6 ? TIMER0A : ((P) == 9 ? TIMER1A : ((P) == 10 ? TIMER1B : NOT_ON_TIMER))))))
+#define portOutputRegister(P) ((P) == PD ? &PORTD : ((P) == PB ? &PORTB : ((P) == PC ? &PORTC : (volatile uint8_t *) 0)))
+#define portInputRegister(P) ((P) == PD ? &PIND : ((P) == PB ? &PINB : ((P) == PC ? &PINC : (volatile uint8_t *) 0)))
+#define portModeRegister(P) ((P) == PD ? &DDRD : ((P) == PB ? &DDRB : ((P) == PC ? &DDRC : (volatile uint8_t *) 0)))
+#define digitalPinToInterrupt(P) ((P) == 2 ? 0 : ((P) == 3 ? 1 : NOT_AN_INTERRUPT))
+#define digitalPinToPCICR(P) (((P) >= 0 && (P) <= 21) ? (&PCICR) : ((SimReg8 *) 0))
+#define digitalPinToPCICRbit(P) (((P) <= 7) ? 2 : (((P) <= 13) ? 0 : 1))
+#define digitalPinToPCMSK(P) (((P) <= 7) ? (&PCMSK2) : (((P) <= 13) ? (&PCMSK0) : (((P) <= 21) ? (&PCMSK1) : \
+                              ((SimReg8 *) 0))))
+#define digitalPinToPCMSKbit(P) (((P) <= 7) ? (P) : (((P) <= 13) ? ((P) - 8) : ((P) - 14)))
+
+//################################################################################################################
+// functions
+//################################################################################################################
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogReference(uint8_t mode);
+void analogWrite(uint8_t pin, int val);
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+// the argument has 16 bit on the target
+void delayMicroseconds(uint16_t us);
+
+void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val);
+uint8_t shiftIn(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder);
+
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode);
+void detachInterrupt(uint8_t interruptNum);
+
+// avr-libc's generator (the same sequences as on the target)
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+// the initialization of the timers and the ADC by the core (called before "setup")
+void init();
+void yield();
+
+#include <HardwareSerial.h>
+
+#endif // SIM_ARDUINO_H_
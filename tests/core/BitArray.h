@@ -0,0 +1,25 @@
+/*
+ BitArray.h of the simulated Arduino core (host builds only, see tests/Readme.txt)
+
+ A stand-in for the external "BitArray" library required by the WSPR library (not part of this repository):
+ bit i of an array is bit (i & 7) of byte (i >> 3), the order the WSPR library's sync vector is stored in.
+*/
+
+#ifndef SIM_BITARRAY_H_
+#define SIM_BITARRAY_H_
+
+#include <stdint.h>
+
+class BitArrayClass {
+
+public:
+  uint8_t getBit(const uint8_t *array, uint16_t pos) { return (array[pos >> 3] >> (pos & 7)) & 1; }
+  void setBit(uint8_t *array, uint16_t pos, uint8_t value) {
+    if(value) { array[pos >> 3] |= 1 << (pos & 7); }
+    else { array[pos >> 3] &= ~(1 << (pos & 7)); }
+  }
+};
+
+extern BitArrayClass BArray;
+
+#endif // SIM_BITARRAY_H_
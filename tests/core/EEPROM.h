@@ -0,0 +1,24 @@
+/*
+ EEPROM.h of the simulated Arduino core (host builds only, see tests/Readme.txt)
+
+ The interface of the EEPROM library used by the sketch (see avr/eeprom.h for the timing).
+*/
+
+#ifndef SIM_EEPROM_H_
+#define SIM_EEPROM_H_
+
+#include <stdint.h>
+#include <avr/eeprom.h>
+
+class EEPROMClass {
+
+public:
+  uint8_t read(int idx) { return eeprom_read_byte((const uint8_t *) (intptr_t) idx); }
+  void write(int idx, uint8_t val) { eeprom_write_byte((uint8_t *) (intptr_t) idx, val); }
+  void update(int idx, uint8_t val) { eeprom_update_byte((uint8_t *) (intptr_t) idx, val); }
+  uint16_t length() { return E2END + 1; }
+};
+
+extern EEPROMClass EEPROM;
+
+#endif // SIM_EEPROM_H_
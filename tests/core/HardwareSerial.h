@@ -0,0 +1,30 @@
+/*
+ HardwareSerial.h of the simulated Arduino core (host builds only, see tests/Readme.txt)
+
+ The USART with the core's 64 byte transmit and receive buffers: a character takes 10 bit times on the line,
+ "write" waits while the transmit buffer is full; received characters are injected by the simulation.
+*/
+
+#ifndef SIM_HARDWARESERIAL_H_
+#define SIM_HARDWARESERIAL_H_
+
+#include <stdint.h>
+#include <Print.h>
+
+class HardwareSerial : public Print {
+
+public:
+  void begin(unsigned long baud);
+  void end();
+  int available();
+  int peek();
+  int read();
+  void flush();
+  size_t write(uint8_t value);
+  using Print::write;
+  operator bool() { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif // SIM_HARDWARESERIAL_H_
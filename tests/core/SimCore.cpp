@@ -0,0 +1,1326 @@
+/*
+ SimCore.cpp of the simulated Arduino core (host builds only, see tests/Readme.txt)
+
+ The engine (see SimCore.h) and the functions of the Arduino core. All state is initialized statically (no
+ constructors are run), as the sketch's global objects already call core functions during static initialization.
+*/
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <BitArray.h>
+#include <avr/sleep.h>
+#include <avr/eeprom.h>
+#include <SimCore.h>
+
+// the sketch
+void setup();
+void loop();
+
+//################################################################################################################
+// CPU cycles charged for the core functions (approximations of the Arduino AVR core 1.8.x, avr-gcc -Os)
+//################################################################################################################
+
+const uint16_t COST_PIN_MODE = 60;
+const uint16_t COST_DIGITAL_WRITE = 56;
+const uint16_t COST_DIGITAL_READ = 50;
+const uint16_t COST_MICROS = 56;
+const uint16_t COST_MILLIS = 40;
+const uint16_t COST_SHIFT_OUT_BIT = 10; // the loop of "shiftOut" (plus 3 calls of "digitalWrite")
+const uint16_t COST_SERIAL_WRITE = 40;
+const uint16_t COST_SERIAL_READ = 30;
+const uint16_t COST_EEPROM_READ = 10;
+const uint16_t COST_EEPROM_WRITE = 20;
+const uint16_t COST_RANDOM = 500; // 32 bit divisions
+// interrupt response (4), jump from the vector table (3), register pushes and pops of the prologue and epilogue
+// (avr-gcc saves all registers used) and "reti" (4)
+const uint16_t COST_ISR_ENTRY = 30;
+const uint16_t COST_ISR_EXIT = 30;
+// the body of the core's timer 0 overflow isr
+const uint16_t COST_TIMER0_ISR = 40;
+// an EEPROM write takes 3.4ms
+const uint32_t EEPROM_WRITE_CYCLES = 3400*sim::CYCLES_PER_US;
+
+//################################################################################################################
+// state of the engine
+//################################################################################################################
+
+namespace {
+
+const uint64_t NEVER = UINT64_MAX;
+
+uint64_t sim_now = 0;
+uint64_t stop_time = NEVER;
+// the next time an event is due (recalculated if "dirty" is set)
+uint64_t deadline = 0;
+bool dirty = true;
+// > 0 while an interrupt routine is executed
+uint8_t isr_depth = 0;
+uint32_t isr_total = 0;
+
+// the I/O clock (timers 0 and 1, ADC) stops in power-save mode: the time it has been stopped in total and since
+// when it's stopped
+bool io_frozen = false;
+uint64_t io_paused = 0;
+uint64_t io_freeze_start = 0;
+
+uint64_t sleep_cycles = 0;
+uint64_t pwr_save_cycles = 0;
+uint32_t wake_ups = 0;
+
+// device events (a binary heap ordered by time and sequence number)
+struct event {
+  uint64_t time;
+  uint64_t seq;
+  sim::event_fn fn;
+  void *ctx;
+};
+const uint8_t MAX_EVENTS = 64;
+event events[MAX_EVENTS];
+uint8_t event_count = 0;
+uint64_t event_seq = 0;
+
+// output pin listeners and the levels last reported (PORTB, PORTC, PORTD)
+struct pin_listener {
+  sim::pin_fn fn;
+  void *ctx;
+};
+const uint8_t MAX_LISTENERS = 8;
+pin_listener listeners[MAX_LISTENERS];
+uint8_t listener_count = 0;
+uint8_t out_last[3] = {0, 0, 0};
+// the levels of the input pins set by the devices
+uint8_t ext_level[3] = {0, 0, 0};
+
+sim::adc_fn adc_source = 0;
+void *adc_ctx = 0;
+
+sim::serial_fn serial_sink = 0;
+void *serial_ctx = 0;
+
+sim::isr_stats isr_stats_table[sim::VECTORS];
+uint16_t isr_cost[sim::VECTORS];
+
+inline uint64_t ioNow() {
+  return (io_frozen ? io_freeze_start : sim_now) - io_paused;
+}
+
+void processDue();
+void poll();
+void snoopPorts();
+
+} // namespace
+
+//################################################################################################################
+// registers
+//################################################################################################################
+
+SIM_REG volatile uint8_t PINB, DDRB, PORTB, PINC, DDRC, PORTC, PIND, DDRD, PORTD;
+
+namespace {
+
+// the timers: the counter value at the last synchronization, the time (in the timer's clock domain) of the last
+// synchronization and the compare values in effect (double buffered in the PWM modes); the configuration decoded
+// from the registers (updated by "configure") and the time the timer sets the next flag of an enabled interrupt
+// (recalculated if "deadline_valid" is cleared by "invalidate")
+struct timer_state {
+  uint16_t count;
+  uint64_t synced;
+  uint16_t ocra;
+  uint16_t ocrb;
+  uint16_t n;
+  uint16_t top;
+  bool ctc;
+  bool buffered;
+  uint64_t deadline;
+  bool deadline_valid;
+};
+timer_state timers[3];
+// the prescaler origins of the synchronous timers (0 and 1; I/O clock domain) and of timer 2
+uint64_t prescaler_origin[2] = {0, 0};
+
+void sregWrite(SimReg8 &reg, uint8_t v);
+void gtccrWrite(SimReg8 &reg, uint8_t v);
+void flagWrite(SimReg8 &reg, uint8_t v);
+void enableWrite(SimReg8 &reg, uint8_t v);
+template<int ID> void timerConfigWrite(SimReg8 &reg, uint8_t v);
+template<int ID> void timerCountRead(SimReg8 &reg, uint8_t v);
+template<int ID> void timerCountWrite(SimReg8 &reg, uint8_t v);
+template<int ID> void timerOCRAWrite(SimReg8 &reg, uint8_t v);
+template<int ID> void timerOCRBWrite(SimReg8 &reg, uint8_t v);
+template<int ID> void timerFlagRead(SimReg8 &reg, uint8_t v);
+template<int ID> void timerFlagWrite(SimReg8 &reg, uint8_t v);
+template<int ID> void timerMaskWrite(SimReg8 &reg, uint8_t v);
+void timer1CountRead(SimReg16 &reg, uint16_t v);
+void timer1CountWrite(SimReg16 &reg, uint16_t v);
+void timer1OCRAWrite(SimReg16 &reg, uint16_t v);
+void timer1OCRBWrite(SimReg16 &reg, uint16_t v);
+void timer1ICRWrite(SimReg16 &reg, uint16_t v);
+void adcsraWrite(SimReg8 &reg, uint8_t v);
+
+} // namespace
+
+SIM_REG SimReg8 SREG(0, sregWrite), SMCR, GTCCR(0, gtccrWrite);
+
+SIM_REG SimReg8 EICRA, EIMSK(0, enableWrite), EIFR(0, flagWrite), PCICR(0, enableWrite), PCIFR(0, flagWrite),
+                PCMSK0, PCMSK1, PCMSK2;
+
+SIM_REG SimReg8 TCCR0A(0, timerConfigWrite<0>), TCCR0B(0, timerConfigWrite<0>),
+                TCNT0(timerCountRead<0>, timerCountWrite<0>), OCR0A(0, timerOCRAWrite<0>),
+                OCR0B(0, timerOCRBWrite<0>), TIMSK0(0, timerMaskWrite<0>),
+                TIFR0(timerFlagRead<0>, timerFlagWrite<0>);
+
+SIM_REG SimReg8 TCCR1A(0, timerConfigWrite<1>), TCCR1B(0, timerConfigWrite<1>), TCCR1C,
+                TIMSK1(0, timerMaskWrite<1>), TIFR1(timerFlagRead<1>, timerFlagWrite<1>);
+SIM_REG SimReg16 TCNT1(timer1CountRead, timer1CountWrite), OCR1A(0, timer1OCRAWrite), OCR1B(0, timer1OCRBWrite),
+                 ICR1(0, timer1ICRWrite);
+
+SIM_REG SimReg8 TCCR2A(0, timerConfigWrite<2>), TCCR2B(0, timerConfigWrite<2>),
+                TCNT2(timerCountRead<2>, timerCountWrite<2>), OCR2A(0, timerOCRAWrite<2>),
+                OCR2B(0, timerOCRBWrite<2>), TIMSK2(0, timerMaskWrite<2>),
+                TIFR2(timerFlagRead<2>, timerFlagWrite<2>), ASSR;
+
+SIM_REG SimReg8 ADMUX, ADCSRA(0, adcsraWrite), ADCSRB, DIDR0, ACSR;
+SIM_REG SimReg16 ADC;
+
+//################################################################################################################
+// timers
+//################################################################################################################
+
+namespace {
+
+SimReg8 &tccra(int id) { return id == 0 ? TCCR0A : (id == 1 ? TCCR1A : TCCR2A); }
+SimReg8 &tccrb(int id) { return id == 0 ? TCCR0B : (id == 1 ? TCCR1B : TCCR2B); }
+SimReg8 &timsk(int id) { return id == 0 ? TIMSK0 : (id == 1 ? TIMSK1 : TIMSK2); }
+SimReg8 &tifr(int id) { return id == 0 ? TIFR0 : (id == 1 ? TIFR1 : TIFR2); }
+
+uint16_t ocraRegister(int id) { return id == 0 ? OCR0A.value : (id == 1 ? OCR1A.value : OCR2A.value); }
+uint16_t ocrbRegister(int id) { return id == 0 ? OCR0B.value : (id == 1 ? OCR1B.value : OCR2B.value); }
+
+// the clock domain: timers 0 and 1 run on the I/O clock, timer 2 keeps running in power-save mode
+inline uint8_t domain(int id) { return id == 2; }
+inline uint64_t domainNow(int id) { return domain(id) ? sim_now : ioNow(); }
+
+uint8_t waveformMode(int id) {
+  if(id == 1) { return (TCCR1A.value & 3) | ((TCCR1B.value >> 1) & 0x0C); }
+  return (tccra(id).value & 3) | ((tccrb(id).value >> 1) & 4);
+}
+
+// the prescaler (0 -> timer stopped; external clock sources aren't available)
+uint16_t prescaler(int id) {
+  static const uint16_t SYNC[8] = {0, 1, 8, 64, 256, 1024, 0, 0};
+  static const uint16_t ASYNC[8] = {0, 1, 8, 32, 64, 128, 256, 1024};
+  uint8_t cs = tccrb(id).value & 7;
+  return (id == 2) ? ASYNC[cs] : SYNC[cs];
+}
+
+uint16_t maxValue(int id) { return (id == 1) ? 0xFFFF : 0xFF; }
+
+// the value the counter is cleared after (TOP)
+uint16_t topValue(int id) {
+  uint8_t mode = waveformMode(id);
+  if(id == 1) {
+    static const uint16_t FIXED[16] = {0xFFFF, 0xFF, 0x1FF, 0x3FF, 0, 0xFF, 0x1FF, 0x3FF, 0, 0, 0, 0, 0, 0, 0, 0};
+    switch(mode) {
+      case 4: case 9: case 11: case 15: return OCR1A.value;
+      case 8: case 10: case 12: case 14: return ICR1.value;
+      default: return FIXED[mode];
+    }
+  }
+  return (mode == 2 || mode == 5 || mode == 7) ? ocraRegister(id) : 0xFF;
+}
+
+bool isCTC(int id) {
+  uint8_t mode = waveformMode(id);
+  return (id == 1) ? (mode == 4 || mode == 12) : (mode == 2);
+}
+
+// the compare registers are double buffered in the PWM modes
+bool isBuffered(int id) {
+  uint8_t mode = waveformMode(id);
+  return (mode != 0) && !isCTC(id);
+}
+
+// decodes the configuration registers (after writing TCCRxA/B, OCRxA or ICR1)
+void configure(int id) {
+  timer_state &t = timers[id];
+  t.n = prescaler(id);
+  t.top = topValue(id);
+  t.ctc = isCTC(id);
+  t.buffered = isBuffered(id);
+}
+
+inline void invalidate(int id) {
+  timers[id].deadline_valid = false;
+  dirty = true;
+}
+
+// sets the flags of "bit" in TIFRx if "v" lies within [first, last]
+inline void flagIfWithin(int id, uint16_t v, uint32_t first, uint32_t last, uint8_t bit) {
+  if(v >= first && v <= last) { tifr(id).value |= (1 << bit); }
+}
+
+// advances a timer by "n" ticks, setting the flags of all compare matches and overflows on the way; a flag is set
+// with the tick the counter leaves the matching value
+void advanceTimer(int id, uint64_t n) {
+  timer_state &t = timers[id];
+  const uint16_t top = t.top;
+  const uint16_t max = maxValue(id);
+  const bool ctc = t.ctc;
+  const bool buffered = t.buffered;
+  // OCFxA, OCFxB and TOVx have the same bit positions in all timers
+  const uint8_t OCFA = 1, OCFB = 2, TOV = 0;
+
+  while(n) {
+    uint32_t c = t.count;
+    uint32_t end = (c > top) ? max : top; // a counter above TOP (e.g. after lowering OCRxA) runs up to MAX
+    uint64_t to_wrap = end - c + 1;
+    uint64_t k = (n < to_wrap) ? n : to_wrap;
+    uint32_t last = c + k - 1;
+
+    flagIfWithin(id, t.ocra, c, last, OCFA);
+    flagIfWithin(id, t.ocrb, c, last, OCFB);
+    n -= k;
+    if(k < to_wrap) {
+      t.count = last + 1;
+      break;
+    }
+
+    if(!ctc || end == max) { tifr(id).value |= (1 << TOV); }
+    t.count = 0;
+    if(buffered) {
+      t.ocra = ocraRegister(id);
+      t.ocrb = ocrbRegister(id);
+    }
+
+    // whole periods set the same flags again
+    uint64_t period = uint64_t(top) + 1;
+    if(n >= period) {
+      flagIfWithin(id, t.ocra, 0, top, OCFA);
+      flagIfWithin(id, t.ocrb, 0, top, OCFB);
+      if(!ctc || top == max) { tifr(id).value |= (1 << TOV); }
+      n %= period;
+    }
+  }
+}
+
+// brings a timer up to date (the deadline stays valid unless a flag has been set)
+void syncTimer(int id) {
+  timer_state &t = timers[id];
+  uint64_t dnow = domainNow(id);
+  if(dnow == t.synced) { return; }
+  uint16_t n = t.n;
+  if(n && dnow > t.synced) {
+    uint64_t origin = prescaler_origin[domain(id)];
+    uint64_t ticks = (dnow - origin)/n - (t.synced - origin)/n;
+    if(ticks) {
+      uint8_t flags = tifr(id).value;
+      advanceTimer(id, ticks);
+      if(tifr(id).value != flags) { invalidate(id); }
+    }
+  }
+  t.synced = dnow;
+}
+
+// the ticks until the counter leaves the value "v" (0 -> never)
+uint64_t ticksToLeave(uint32_t c, uint32_t end, uint32_t top, uint32_t v) {
+  if(v >= c && v <= end) { return v - c + 1; }
+  if(v <= top) { return uint64_t(end - c + 1) + v + 1; }
+  return 0;
+}
+
+// the time a timer sets the next flag of an enabled interrupt, whose flag isn't set yet (NEVER -> none)
+uint64_t timerDeadline(int id) {
+  uint16_t n = timers[id].n;
+  if(!n || (domain(id) == 0 && io_frozen)) { return NEVER; }
+  uint8_t pending = timsk(id).value & ~tifr(id).value & 7; // TOIE/OCIEA/OCIEB match TOV/OCFA/OCFB
+  if(!pending) { return NEVER; }
+
+  const timer_state &t = timers[id];
+  uint32_t c = t.count, top = t.top, max = maxValue(id);
+  uint32_t end = (c > top) ? max : top;
+  uint64_t best = 0;
+  auto consider = [&best](uint64_t d) { if(d && (!best || d < best)) { best = d; } };
+
+  if(pending & 2) {
+    consider(ticksToLeave(c, end, top, t.ocra));
+    consider(ticksToLeave(c, end, top, ocraRegister(id)));
+  }
+  if(pending & 4) {
+    consider(ticksToLeave(c, end, top, t.ocrb));
+    consider(ticksToLeave(c, end, top, ocrbRegister(id)));
+  }
+  if(pending & 1) {
+    if(!t.ctc || end == max) { consider(end - c + 1); }
+    else if(top == max) { consider(uint64_t(end - c + 1) + top + 1); }
+  }
+  if(!best) { return NEVER; }
+
+  uint64_t origin = prescaler_origin[domain(id)];
+  uint64_t tick = (t.synced - origin)/n + best;
+  uint64_t time = origin + tick*n;
+  return domain(id) ? time : time + io_paused;
+}
+
+template<int ID> void timerConfigWrite(SimReg8 &reg, uint8_t v) {
+  syncTimer(ID);
+  reg.value = v;
+  configure(ID);
+  if(!timers[ID].buffered) {
+    timers[ID].ocra = ocraRegister(ID);
+    timers[ID].ocrb = ocrbRegister(ID);
+  }
+  invalidate(ID);
+}
+
+template<int ID> void timerCountRead(SimReg8 &reg, uint8_t) {
+  syncTimer(ID);
+  reg.value = timers[ID].count;
+}
+
+template<int ID> void timerCountWrite(SimReg8 &reg, uint8_t v) {
+  syncTimer(ID);
+  reg.value = v;
+  timers[ID].count = v;
+  invalidate(ID);
+}
+
+template<int ID> void timerOCRAWrite(SimReg8 &reg, uint8_t v) {
+  syncTimer(ID);
+  reg.value = v;
+  configure(ID);
+  if(!timers[ID].buffered) { timers[ID].ocra = v; }
+  invalidate(ID);
+}
+
+template<int ID> void timerOCRBWrite(SimReg8 &reg, uint8_t v) {
+  syncTimer(ID);
+  reg.value = v;
+  if(!timers[ID].buffered) { timers[ID].ocrb = v; }
+  invalidate(ID);
+}
+
+template<int ID> void timerFlagRead(SimReg8 &, uint8_t) {
+  syncTimer(ID);
+}
+
+// the flags are cleared by writing 1
+template<int ID> void timerFlagWrite(SimReg8 &reg, uint8_t v) {
+  syncTimer(ID);
+  reg.value &= ~v;
+  invalidate(ID);
+}
+
+template<int ID> void timerMaskWrite(SimReg8 &reg, uint8_t v) {
+  syncTimer(ID);
+  reg.value = v;
+  invalidate(ID);
+  poll();
+}
+
+void timer1CountRead(SimReg16 &reg, uint16_t) {
+  syncTimer(1);
+  reg.value = timers[1].count;
+}
+
+void timer1CountWrite(SimReg16 &reg, uint16_t v) {
+  syncTimer(1);
+  reg.value = v;
+  timers[1].count = v;
+  invalidate(1);
+}
+
+void timer1OCRAWrite(SimReg16 &reg, uint16_t v) {
+  syncTimer(1);
+  reg.value = v;
+  configure(1);
+  if(!timers[1].buffered) { timers[1].ocra = v; }
+  invalidate(1);
+}
+
+void timer1OCRBWrite(SimReg16 &reg, uint16_t v) {
+  syncTimer(1);
+  reg.value = v;
+  if(!timers[1].buffered) { timers[1].ocrb = v; }
+  invalidate(1);
+}
+
+void timer1ICRWrite(SimReg16 &reg, uint16_t v) {
+  syncTimer(1);
+  reg.value = v;
+  configure(1);
+  invalidate(1);
+}
+
+// PSRASY resets the prescaler of timer 2, PSRSYNC the one of timers 0 and 1 (both bits clear themselves)
+void gtccrWrite(SimReg8 &reg, uint8_t v) {
+  if(v & (1 << PSRASY)) {
+    syncTimer(2);
+    prescaler_origin[1] = sim_now;
+    invalidate(2);
+  }
+  if(v & (1 << PSRSYNC)) {
+    syncTimer(0);
+    syncTimer(1);
+    prescaler_origin[0] = ioNow();
+    timers[0].synced = timers[1].synced = prescaler_origin[0];
+    invalidate(0);
+    invalidate(1);
+  }
+  reg.value = (v & (1 << TSM)) ? v : v & ~((1 << PSRASY) | (1 << PSRSYNC));
+  dirty = true;
+}
+
+//################################################################################################################
+// ADC (single conversions: 13 ADC clock cycles, 25 for the first one after enabling the ADC)
+//################################################################################################################
+
+bool adc_busy = false;
+bool adc_first = true;
+uint8_t adc_channel = 0;
+uint64_t adc_done = 0; // I/O clock domain
+
+uint64_t adcDeadline() {
+  if(!adc_busy || io_frozen) { return NEVER; }
+  return adc_done + io_paused;
+}
+
+void adcComplete() {
+  uint16_t value = adc_source ? adc_source(adc_ctx, adc_channel) : 0;
+  ADC.value = (value > 1023) ? 1023 : value;
+  ADCSRA.value = (ADCSRA.value & ~(1 << ADSC)) | (1 << ADIF);
+  adc_busy = false;
+}
+
+// ADIF is cleared by writing 1; ADSC starts a conversion (writing 0 has no effect)
+void adcsraWrite(SimReg8 &reg, uint8_t v) {
+  uint8_t flag = reg.value & (1 << ADIF) & ~v;
+  reg.value = (v & ~((1 << ADIF) | (1 << ADSC))) | flag | (adc_busy ? (1 << ADSC) : 0);
+
+  if(!(v & (1 << ADEN))) {
+    adc_first = true;
+  }
+  else if((v & (1 << ADSC)) && !adc_busy) {
+    uint8_t ps = v & 7;
+    uint32_t clocks = adc_first ? 25 : 13;
+    adc_busy = true;
+    adc_first = false;
+    adc_channel = ADMUX.value & 0x0F;
+    adc_done = ioNow() + (uint64_t(clocks) << (ps ? ps : 1));
+    reg.value |= (1 << ADSC);
+  }
+  dirty = true;
+  poll();
+}
+
+//################################################################################################################
+// interrupts
+//################################################################################################################
+
+// interrupt flags are cleared by writing 1
+void flagWrite(SimReg8 &reg, uint8_t v) {
+  reg.value &= ~v;
+}
+
+void enableWrite(SimReg8 &reg, uint8_t v) {
+  reg.value = v;
+  poll();
+}
+
+void sregWrite(SimReg8 &reg, uint8_t v) {
+  reg.value = v;
+  snoopPorts();
+  if(v & (1 << SREG_I)) { poll(); }
+}
+
+} // namespace
+
+// the vectors provided by the sketch and its libraries (weak references: 0 if not defined)
+#define SIM_WEAK_VECTOR(n) extern "C" void __vector_##n(void) __attribute__((weak));
+SIM_WEAK_VECTOR(3) SIM_WEAK_VECTOR(4) SIM_WEAK_VECTOR(5) SIM_WEAK_VECTOR(7) SIM_WEAK_VECTOR(8)
+SIM_WEAK_VECTOR(9) SIM_WEAK_VECTOR(10) SIM_WEAK_VECTOR(11) SIM_WEAK_VECTOR(12) SIM_WEAK_VECTOR(13)
+SIM_WEAK_VECTOR(14) SIM_WEAK_VECTOR(15) SIM_WEAK_VECTOR(21)
+#undef SIM_WEAK_VECTOR
+
+// the vectors of the core (external interrupts and timer 0 overflow)
+extern "C" void __vector_1(void);
+extern "C" void __vector_2(void);
+extern "C" void __vector_16(void);
+
+namespace {
+
+struct vector_entry {
+  uint8_t number;
+  void (*fn)(void);
+  SimReg8 *flag_reg;
+  uint8_t flag_bit;
+  SimReg8 *enable_reg;
+  uint8_t enable_bit;
+  int8_t timer; // the timer setting the flag (-1 -> none)
+};
+
+// in the order of priority (the order of the bits of "pendingMask")
+const vector_entry VECTOR_TABLE[] = {
+  {1, __vector_1, &EIFR, INTF0, &EIMSK, INT0, -1},
+  {2, __vector_2, &EIFR, INTF1, &EIMSK, INT1, -1},
+  {3, __vector_3, &PCIFR, PCIF0, &PCICR, PCIE0, -1},
+  {4, __vector_4, &PCIFR, PCIF1, &PCICR, PCIE1, -1},
+  {5, __vector_5, &PCIFR, PCIF2, &PCICR, PCIE2, -1},
+  {7, __vector_7, &TIFR2, OCF2A, &TIMSK2, OCIE2A, 2},
+  {8, __vector_8, &TIFR2, OCF2B, &TIMSK2, OCIE2B, 2},
+  {9, __vector_9, &TIFR2, TOV2, &TIMSK2, TOIE2, 2},
+  {10, __vector_10, &TIFR1, ICF1, &TIMSK1, ICIE1, 1},
+  {11, __vector_11, &TIFR1, OCF1A, &TIMSK1, OCIE1A, 1},
+  {12, __vector_12, &TIFR1, OCF1B, &TIMSK1, OCIE1B, 1},
+  {13, __vector_13, &TIFR1, TOV1, &TIMSK1, TOIE1, 1},
+  {14, __vector_14, &TIFR0, OCF0A, &TIMSK0, OCIE0A, 0},
+  {15, __vector_15, &TIFR0, OCF0B, &TIMSK0, OCIE0B, 0},
+  {16, __vector_16, &TIFR0, TOV0, &TIMSK0, TOIE0, 0},
+  {21, __vector_21, &ADCSRA, ADIF, &ADCSRA, ADIE, -1}
+};
+static_assert(sizeof(VECTOR_TABLE)/sizeof(VECTOR_TABLE[0]) == 16, "pendingMask() has a bit for each entry");
+
+void chargeRaw(uint32_t cycles);
+
+// the pending interrupts (flag and enable bit set) as a bit mask in the order of priority (bit i -> VECTOR_TABLE[i])
+inline uint32_t pendingMask() {
+  // TOVx/OCFxA/OCFxB (bits 0/1/2) -> OCFxA, OCFxB, TOVx
+  static const uint8_t TIMER_ORDER[8] = {0, 4, 1, 5, 2, 6, 3, 7};
+  uint8_t t1 = TIFR1.value & TIMSK1.value;
+  return uint32_t(EIFR.value & EIMSK.value & 3) | (uint32_t(PCIFR.value & PCICR.value & 7) << 2) |
+         (uint32_t(TIMER_ORDER[TIFR2.value & TIMSK2.value & 7]) << 5) | (uint32_t((t1 >> ICF1) & 1) << 8) |
+         (uint32_t(TIMER_ORDER[t1 & 7]) << 9) | (uint32_t(TIMER_ORDER[TIFR0.value & TIMSK0.value & 7]) << 12) |
+         (uint32_t(ADCSRA.value & (ADCSRA.value << 1) & (1 << ADIF)) << (15 - ADIF)); // ADIE is the bit below ADIF
+}
+
+// executes the pending interrupts (if interrupts are enabled); the flag is cleared by the hardware when the
+// routine is entered, interrupts are disabled until it returns
+void poll() {
+  while(SREG.value & (1 << SREG_I)) {
+    uint32_t pending = pendingMask();
+    if(!pending) { return; }
+    const vector_entry *v = &VECTOR_TABLE[__builtin_ctz(pending)];
+    if(!v->fn) { sim::fail("interrupt %d enabled without an interrupt routine (the target would reset)", v->number); }
+
+    v->flag_reg->value &= ~(1 << v->flag_bit);
+    if(v->timer >= 0) { invalidate(v->timer); }
+    SREG.value &= ~(1 << SREG_I);
+    ++isr_depth;
+    ++isr_total;
+    dirty = true;
+    uint64_t start = sim_now;
+    chargeRaw(COST_ISR_ENTRY + isr_cost[v->number]);
+    v->fn();
+    chargeRaw(COST_ISR_EXIT);
+    --isr_depth;
+    dirty = true;
+    SREG.value |= (1 << SREG_I);
+    snoopPorts();
+
+    sim::isr_stats &s = isr_stats_table[v->number];
+    uint64_t cycles = sim_now - start;
+    s.count++;
+    s.cycles += cycles;
+    if(cycles > s.max) { s.max = cycles; }
+  }
+}
+
+//################################################################################################################
+// event processing
+//################################################################################################################
+
+void heapPop() {
+  events[0] = events[--event_count];
+  uint8_t i = 0;
+  for(;;) {
+    uint8_t l = 2*i + 1, r = l + 1, m = i;
+    auto before = [](const event &a, const event &b) { return a.time < b.time || (a.time == b.time && a.seq < b.seq); };
+    if(l < event_count && before(events[l], events[m])) { m = l; }
+    if(r < event_count && before(events[r], events[m])) { m = r; }
+    if(m == i) { break; }
+    event tmp = events[i];
+    events[i] = events[m];
+    events[m] = tmp;
+    i = m;
+  }
+}
+
+void recalculate() {
+  deadline = isr_depth ? NEVER : stop_time;
+  if(event_count && events[0].time < deadline) { deadline = events[0].time; }
+  for(int id=0; id<3; id++) {
+    timer_state &t = timers[id];
+    if(!t.deadline_valid) {
+      t.deadline = timerDeadline(id);
+      t.deadline_valid = true;
+    }
+    if(t.deadline < deadline) { deadline = t.deadline; }
+  }
+  uint64_t t = adcDeadline();
+  if(t < deadline) { deadline = t; }
+  dirty = false;
+}
+
+// processes everything due up to now (sets the flags, calls the device events and executes the interrupt routines)
+void processDue() {
+  for(;;) {
+    if(dirty) { recalculate(); }
+    if(deadline > sim_now) { return; }
+    if(!isr_depth && sim_now >= stop_time) { throw sim::Stop(); }
+
+    // (the timers not due are synchronized when their registers are accessed)
+    for(int id=0; id<3; id++) {
+      if(timers[id].deadline <= sim_now) {
+        syncTimer(id);
+        invalidate(id);
+      }
+    }
+    if(adc_busy && !io_frozen && adc_done <= ioNow()) { adcComplete(); }
+    while(event_count && events[0].time <= sim_now) {
+      event e = events[0];
+      heapPop();
+      e.fn(e.ctx);
+    }
+    dirty = true;
+    poll();
+  }
+}
+
+// lets time pass (interrupt routines running meanwhile extend the time accordingly)
+void chargeRaw(uint32_t cycles) {
+  uint64_t remaining = cycles;
+  for(;;) {
+    if(dirty) { recalculate(); }
+    if(deadline > sim_now + remaining) {
+      sim_now += remaining;
+      return;
+    }
+    if(deadline > sim_now) {
+      remaining -= deadline - sim_now;
+      sim_now = deadline;
+    }
+    processDue();
+  }
+}
+
+//################################################################################################################
+// pins
+//################################################################################################################
+
+// port index (0 -> B, 1 -> C, 2 -> D) and bit of a pin
+inline uint8_t portIndex(uint8_t pin) { return (pin < 8) ? 2 : ((pin < 14) ? 0 : 1); }
+inline uint8_t portBit(uint8_t pin) { return (pin < 8) ? pin : ((pin < 14) ? pin - 8 : pin - 14); }
+
+volatile uint8_t *portReg(uint8_t index) { return index == 0 ? &PORTB : (index == 1 ? &PORTC : &PORTD); }
+volatile uint8_t *ddrReg(uint8_t index) { return index == 0 ? &DDRB : (index == 1 ? &DDRC : &DDRD); }
+volatile uint8_t *pinReg(uint8_t index) { return index == 0 ? &PINB : (index == 1 ? &PINC : &PIND); }
+
+inline uint8_t pinNumber(uint8_t index, uint8_t bit) { return index == 0 ? 8 + bit : (index == 1 ? 14 + bit : bit); }
+
+// updates the input registers and reports changed output levels to the listeners
+void snoopPorts() {
+  static volatile uint8_t *const DDR[3] = {&DDRB, &DDRC, &DDRD};
+  static volatile uint8_t *const PORT[3] = {&PORTB, &PORTC, &PORTD};
+  static volatile uint8_t *const PIN[3] = {&PINB, &PINC, &PIND};
+  for(uint8_t p=0; p<3; p++) {
+    uint8_t ddr = *DDR[p];
+    uint8_t out = *PORT[p] & ddr;
+    *PIN[p] = out | (ext_level[p] & ~ddr);
+    uint8_t changed = out ^ out_last[p];
+    if(changed) {
+      out_last[p] = out;
+      for(uint8_t b=0; b<8; b++) {
+        if(changed & (1 << b)) {
+          for(uint8_t i=0; i<listener_count; i++) {
+            listeners[i].fn(listeners[i].ctx, pinNumber(p, b), (out >> b) & 1);
+          }
+        }
+      }
+    }
+  }
+}
+
+} // namespace
+
+//################################################################################################################
+// engine interface
+//################################################################################################################
+
+namespace sim {
+
+uint64_t now() {
+  return sim_now;
+}
+
+void charge(uint32_t cycles) {
+  chargeRaw(cycles);
+}
+
+void setStopTime(uint64_t time) {
+  stop_time = time;
+  dirty = true;
+}
+
+void fail(const char *format, ...) {
+  fflush(stdout);
+  fprintf(stderr, "SIMULATION FAILED at %.6fs: ", double(sim_now)/CYCLES_PER_SECOND);
+  va_list args;
+  va_start(args, format);
+  vfprintf(stderr, format, args);
+  va_end(args);
+  fprintf(stderr, "\n");
+  exit(2);
+}
+
+void schedule(uint64_t time, event_fn fn, void *ctx) {
+  if(event_count == MAX_EVENTS) { fail("too many events scheduled"); }
+  uint8_t i = event_count++;
+  events[i] = {time, event_seq++, fn, ctx};
+  while(i) {
+    uint8_t parent = (i - 1)/2;
+    const event &a = events[i], &b = events[parent];
+    if(!(a.time < b.time || (a.time == b.time && a.seq < b.seq))) { break; }
+    event tmp = events[i];
+    events[i] = events[parent];
+    events[parent] = tmp;
+    i = parent;
+  }
+  dirty = true;
+}
+
+void setInput(uint8_t pin, uint8_t level) {
+  uint8_t p = portIndex(pin), b = portBit(pin), mask = 1 << b;
+  level = level ? mask : 0;
+  if((ext_level[p] & mask) == level) { return; }
+  ext_level[p] = (ext_level[p] & ~mask) | level;
+  if(*ddrReg(p) & mask) { return; } // an output pin isn't affected
+  *pinReg(p) = (*pinReg(p) & ~mask) | level;
+
+  // INT0 (PD2) and INT1 (PD3): the edge detection needs the I/O clock; the low level interrupt isn't available
+  if(p == 2 && (b == 2 || b == 3) && !io_frozen) {
+    uint8_t n = b - 2;
+    uint8_t mode = (EICRA.value >> (2*n)) & 3;
+    if(mode == 1 || (mode == 2 && !level) || (mode == 3 && level)) { EIFR.value |= (1 << n); }
+  }
+  // pin change interrupts (asynchronous, also detected while sleeping)
+  SimReg8 &pcmsk = (p == 0) ? PCMSK0 : ((p == 1) ? PCMSK1 : PCMSK2);
+  if(pcmsk.value & mask) { PCIFR.value |= (1 << p); }
+  // input capture of timer 1 at ICP1 (PB0)
+  if(p == 0 && b == 0 && timers[1].n && !io_frozen) {
+    if(((TCCR1B.value >> ICES1) & 1) == (level ? 1 : 0)) {
+      syncTimer(1);
+      ICR1.value = timers[1].count;
+      TIFR1.value |= (1 << ICF1);
+      invalidate(1);
+    }
+  }
+
+  dirty = true;
+  poll();
+}
+
+void onPinChange(pin_fn fn, void *ctx) {
+  if(listener_count == MAX_LISTENERS) { fail("too many pin listeners"); }
+  listeners[listener_count++] = {fn, ctx};
+}
+
+void setADCSource(adc_fn fn, void *ctx) {
+  adc_source = fn;
+  adc_ctx = ctx;
+}
+
+void setSerialSink(serial_fn fn, void *ctx) {
+  serial_sink = fn;
+  serial_ctx = ctx;
+}
+
+void setISRCost(uint8_t vector, uint16_t cycles) {
+  if(vector < VECTORS) { isr_cost[vector] = cycles; }
+}
+
+const isr_stats &getISRStats(uint8_t vector) {
+  return isr_stats_table[vector < VECTORS ? vector : 0];
+}
+
+uint64_t sleepCycles() {
+  return sleep_cycles;
+}
+
+uint64_t powerSaveCycles() {
+  return pwr_save_cycles;
+}
+
+uint32_t wakeUps() {
+  return wake_ups;
+}
+
+void run(uint32_t loop_cycles) {
+  try {
+    init();
+    setup();
+    for(;;) {
+      loop();
+      chargeRaw(loop_cycles);
+    }
+  }
+  catch(Stop &) { }
+}
+
+} // namespace sim
+
+//################################################################################################################
+// sleep
+//################################################################################################################
+
+void simCli() {
+  SREG.value &= ~(1 << SREG_I);
+  chargeRaw(1);
+}
+
+void simSei() {
+  SREG.value |= (1 << SREG_I);
+  chargeRaw(1);
+  poll();
+}
+
+// the MCU sleeps until an interrupt routine has been executed; in power-save mode the I/O clock is stopped (timers
+// 0 and 1, ADC, edge detection of INT0/INT1), timer 2 and the pin change interrupts keep running
+void simSleep() {
+  if(!(SMCR.value & (1 << SE))) { return; }
+  if(!(SREG.value & (1 << SREG_I))) { sim::fail("sleeping with interrupts disabled (the MCU would never wake up)"); }
+  uint8_t mode = (SMCR.value >> SM0) & 7;
+  if(mode != 0 && mode != 3) { sim::fail("sleep mode %d isn't available", mode); }
+
+  chargeRaw(1);
+  uint64_t start = sim_now;
+  uint32_t isr_before = isr_total;
+  if(mode == 3) {
+    syncTimer(0);
+    syncTimer(1);
+    io_freeze_start = sim_now;
+    io_frozen = true;
+    invalidate(0);
+    invalidate(1);
+  }
+
+  while(isr_total == isr_before) {
+    if(dirty) { recalculate(); }
+    if(deadline == NEVER) { sim::fail("sleeping without any wake-up source (the MCU would never wake up)"); }
+    if(deadline > sim_now) { sim_now = deadline; }
+    processDue();
+  }
+
+  if(mode == 3) {
+    io_paused += sim_now - io_freeze_start;
+    io_frozen = false;
+    invalidate(0);
+    invalidate(1);
+    pwr_save_cycles += sim_now - start;
+  }
+  sleep_cycles += sim_now - start;
+  ++wake_ups;
+}
+
+//################################################################################################################
+// Arduino core: wiring.c
+//################################################################################################################
+
+volatile unsigned long timer0_overflow_count = 0;
+volatile unsigned long timer0_millis = 0;
+static unsigned char timer0_fract = 0;
+
+namespace {
+
+// "uint8_t sreg = SREG; cli();" and "SREG = sreg;" without the port snooping of SREG writes
+inline uint8_t irqSave() {
+  uint8_t s = SREG.value;
+  SREG.value &= ~(1 << SREG_I);
+  return s;
+}
+
+inline void irqRestore(uint8_t s) {
+  SREG.value = s;
+  if(s & (1 << SREG_I)) { poll(); }
+}
+
+} // namespace
+
+ISR(TIMER0_OVF_vect) {
+  unsigned long m = timer0_millis;
+  unsigned char f = timer0_fract;
+
+  m += 1;
+  f += 3;
+  if(f >= 125) {
+    f -= 125;
+    m += 1;
+  }
+
+  timer0_fract = f;
+  timer0_millis = m;
+  timer0_overflow_count++;
+}
+
+unsigned long millis() {
+  chargeRaw(COST_MILLIS);
+  uint8_t s = irqSave();
+  unsigned long m = timer0_millis;
+  irqRestore(s);
+
+  return uint32_t(m);
+}
+
+unsigned long micros() {
+  chargeRaw(COST_MICROS);
+  uint8_t s = irqSave();
+  unsigned long m = timer0_overflow_count;
+  uint8_t t = TCNT0;
+  if((TIFR0 & (1 << TOV0)) && (t < 255)) { m++; }
+  irqRestore(s);
+
+  return uint32_t(((m << 8) + t)*4);
+}
+
+void delay(unsigned long ms) {
+  uint32_t start = micros();
+
+  while(ms > 0) {
+    yield();
+    uint32_t elapsed = micros() - start;
+    while(ms > 0 && elapsed >= 1000) {
+      ms--;
+      start += 1000;
+      elapsed -= 1000;
+    }
+    if(ms > 0) { chargeRaw((1000 - elapsed)*sim::CYCLES_PER_US); }
+  }
+}
+
+void delayMicroseconds(uint16_t us) {
+  chargeRaw(us > 1 ? uint32_t(us)*sim::CYCLES_PER_US : 16);
+}
+
+// the initialization of the timers and the ADC by the core (timers 1 and 2: phase correct PWM, prescaler 64)
+void init() {
+  sei();
+  TCCR0A = (1 << WGM01) | (1 << WGM00);
+  TCCR0B = (1 << CS01) | (1 << CS00);
+  TIMSK0 = (1 << TOIE0);
+  TCCR1B = (1 << CS11) | (1 << CS10);
+  TCCR1A = (1 << WGM10);
+  TCCR2B = (1 << CS22);
+  TCCR2A = (1 << WGM20);
+  ADCSRA = (1 << ADPS2) | (1 << ADPS1) | (1 << ADPS0) | (1 << ADEN);
+}
+
+void yield() { }
+
+//################################################################################################################
+// Arduino core: wiring_digital.c, wiring_analog.c, wiring_shift.c
+//################################################################################################################
+
+namespace {
+
+// "digitalWrite" and "digitalRead" turn off the PWM output of a timer pin
+void turnOffPWM(uint8_t pin) {
+  switch(digitalPinToTimer(pin)) {
+    case TIMER0A: TCCR0A &= ~(1 << 7); break;
+    case TIMER0B: TCCR0A &= ~(1 << 5); break;
+    case TIMER1A: TCCR1A &= ~(1 << 7); break;
+    case TIMER1B: TCCR1A &= ~(1 << 5); break;
+    case TIMER2A: TCCR2A &= ~(1 << COM2A1); break;
+    case TIMER2B: TCCR2A &= ~(1 << COM2B1); break;
+  }
+}
+
+uint8_t analog_reference = DEFAULT;
+
+} // namespace
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  chargeRaw(COST_PIN_MODE);
+  if(pin >= NUM_DIGITAL_PINS) { return; }
+  uint8_t p = portIndex(pin), mask = 1 << portBit(pin);
+  uint8_t s = irqSave();
+  if(mode == OUTPUT) { *ddrReg(p) |= mask; }
+  else {
+    *ddrReg(p) &= ~mask;
+    if(mode == INPUT_PULLUP) { *portReg(p) |= mask; }
+    else { *portReg(p) &= ~mask; }
+  }
+  snoopPorts();
+  irqRestore(s);
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  chargeRaw(COST_DIGITAL_WRITE);
+  if(pin >= NUM_DIGITAL_PINS) { return; }
+  turnOffPWM(pin);
+  uint8_t p = portIndex(pin), mask = 1 << portBit(pin);
+  uint8_t s = irqSave();
+  if(val == LOW) { *portReg(p) &= ~mask; }
+  else { *portReg(p) |= mask; }
+  snoopPorts();
+  irqRestore(s);
+}
+
+int digitalRead(uint8_t pin) {
+  chargeRaw(COST_DIGITAL_READ);
+  if(pin >= NUM_DIGITAL_PINS) { return LOW; }
+  turnOffPWM(pin);
+  return (*pinReg(portIndex(pin)) >> portBit(pin)) & 1;
+}
+
+void analogReference(uint8_t mode) {
+  analog_reference = mode;
+}
+
+int analogRead(uint8_t pin) {
+  if(pin >= 14) { pin -= 14; }
+  ADMUX = (analog_reference << 6) | (pin & 7);
+  ADCSRA |= (1 << ADSC);
+  while(ADCSRA & (1 << ADSC)) { chargeRaw(8); }
+
+  return ADC;
+}
+
+// the PWM outputs aren't modelled: the pin is set high for a duty cycle of 50% and more
+void analogWrite(uint8_t pin, int val) {
+  pinMode(pin, OUTPUT);
+  digitalWrite(pin, val >= 128 ? HIGH : LOW);
+}
+
+void shiftOut(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder, uint8_t val) {
+  for(uint8_t i=0; i<8; i++) {
+    chargeRaw(COST_SHIFT_OUT_BIT);
+    if(bitOrder == LSBFIRST) { digitalWrite(dataPin, !!(val & (1 << i))); }
+    else { digitalWrite(dataPin, !!(val & (1 << (7 - i)))); }
+    digitalWrite(clockPin, HIGH);
+    digitalWrite(clockPin, LOW);
+  }
+}
+
+uint8_t shiftIn(uint8_t dataPin, uint8_t clockPin, uint8_t bitOrder) {
+  uint8_t value = 0;
+  for(uint8_t i=0; i<8; i++) {
+    chargeRaw(COST_SHIFT_OUT_BIT);
+    digitalWrite(clockPin, HIGH);
+    if(bitOrder == LSBFIRST) { value |= digitalRead(dataPin) << i; }
+    else { value |= digitalRead(dataPin) << (7 - i); }
+    digitalWrite(clockPin, LOW);
+  }
+
+  return value;
+}
+
+//################################################################################################################
+// Arduino core: WInterrupts.c
+//################################################################################################################
+
+namespace {
+
+void nothing() { }
+void (*int_function[2])() = {nothing, nothing};
+
+} // namespace
+
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode) {
+  if(interruptNum < 2) {
+    int_function[interruptNum] = userFunc;
+    EICRA = (EICRA & ~(3 << (2*interruptNum))) | (mode << (2*interruptNum));
+    EIMSK |= (1 << interruptNum);
+  }
+}
+
+void detachInterrupt(uint8_t interruptNum) {
+  if(interruptNum < 2) {
+    EIMSK &= ~(1 << interruptNum);
+    int_function[interruptNum] = nothing;
+  }
+}
+
+ISR(INT0_vect) {
+  int_function[0]();
+}
+
+ISR(INT1_vect) {
+  int_function[1]();
+}
+
+//################################################################################################################
+// Arduino core: WMath.cpp (with avr-libc's "random")
+//################################################################################################################
+
+namespace {
+
+uint32_t random_next = 1;
+
+// the Park-Miller generator of avr-libc
+int32_t doRandom() {
+  int32_t x = random_next;
+  if(x == 0) { x = 123459876L; }
+  int32_t hi = x/127773L;
+  int32_t lo = x%127773L;
+  x = 16807L*lo - 2836L*hi;
+  if(x < 0) { x += 0x7FFFFFFFL; }
+  random_next = x;
+
+  return x % (0x7FFFFFFFUL + 1);
+}
+
+} // namespace
+
+long random(long howbig) {
+  chargeRaw(COST_RANDOM);
+  if(howbig == 0) { return 0; }
+  return doRandom() % howbig;
+}
+
+long random(long howsmall, long howbig) {
+  if(howsmall >= howbig) { return howsmall; }
+  return random(howbig - howsmall) + howsmall;
+}
+
+void randomSeed(unsigned long seed) {
+  if(seed != 0) { random_next = uint32_t(seed); }
+}
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  return (x - in_min)*(out_max - out_min)/(in_max - in_min) + out_min;
+}
+
+//################################################################################################################
+// Arduino core: HardwareSerial.cpp (8N1; the characters are handed to the sink when written)
+//################################################################################################################
+
+namespace {
+
+const uint8_t SERIAL_BUFFER_SIZE = 64;
+bool serial_on = false;
+uint32_t serial_char_cycles = 0;
+// the time the transmission of the last character written ends
+uint64_t serial_tx_end = 0;
+uint8_t serial_rx[SERIAL_BUFFER_SIZE];
+uint8_t serial_rx_head = 0;
+uint8_t serial_rx_tail = 0;
+
+} // namespace
+
+HardwareSerial Serial;
+
+void HardwareSerial::begin(unsigned long baud) {
+  serial_on = true;
+  serial_char_cycles = uint32_t(10ULL*sim::CYCLES_PER_SECOND/baud);
+}
+
+void HardwareSerial::end() {
+  flush();
+  serial_on = false;
+}
+
+int HardwareSerial::available() {
+  return uint8_t(serial_rx_head - serial_rx_tail) % SERIAL_BUFFER_SIZE;
+}
+
+int HardwareSerial::peek() {
+  if(serial_rx_head == serial_rx_tail) { return -1; }
+  return serial_rx[serial_rx_tail];
+}
+
+int HardwareSerial::read() {
+  chargeRaw(COST_SERIAL_READ);
+  if(serial_rx_head == serial_rx_tail) { return -1; }
+  uint8_t c = serial_rx[serial_rx_tail];
+  serial_rx_tail = (serial_rx_tail + 1) % SERIAL_BUFFER_SIZE;
+
+  return c;
+}
+
+void HardwareSerial::flush() {
+  if(serial_tx_end > sim_now) { chargeRaw(serial_tx_end - sim_now); }
+}
+
+// waits while the transmit buffer is full (the transmit shift register holds one more character)
+size_t HardwareSerial::write(uint8_t value) {
+  chargeRaw(COST_SERIAL_WRITE);
+  if(!serial_on) { return 1; }
+
+  uint64_t limit = uint64_t(SERIAL_BUFFER_SIZE)*serial_char_cycles;
+  if(serial_tx_end > sim_now + limit) { chargeRaw(serial_tx_end - limit - sim_now); }
+  serial_tx_end = ((serial_tx_end > sim_now) ? serial_tx_end : sim_now) + serial_char_cycles;
+  if(serial_sink) { serial_sink(serial_ctx, value); }
+
+  return 1;
+}
+
+void sim::serialReceive(uint8_t c) {
+  uint8_t next = (serial_rx_head + 1) % SERIAL_BUFFER_SIZE;
+  if(!serial_on || next == serial_rx_tail) { return; } // overrun
+  serial_rx[serial_rx_head] = c;
+  serial_rx_head = next;
+}
+
+//################################################################################################################
+// avr-libc: eeprom (the cells are stored inverted, so that the erased state is the initial one)
+//################################################################################################################
+
+namespace {
+
+const uint16_t EEPROM_SIZE = E2END + 1;
+uint8_t eeprom_inverted[EEPROM_SIZE];
+uint32_t eeprom_write_count[EEPROM_SIZE];
+uint64_t eeprom_ready = 0;
+
+inline uint16_t eepromAddress(const uint8_t *address) {
+  uintptr_t a = uintptr_t(address);
+  if(a >= EEPROM_SIZE) { sim::fail("EEPROM address %lu out of range", (unsigned long) a); }
+  return a;
+}
+
+} // namespace
+
+EEPROMClass EEPROM;
+
+int eeprom_is_ready() {
+  return sim_now >= eeprom_ready;
+}
+
+void eeprom_busy_wait() {
+  if(sim_now < eeprom_ready) { chargeRaw(eeprom_ready - sim_now); }
+}
+
+uint8_t eeprom_read_byte(const uint8_t *address) {
+  eeprom_busy_wait();
+  chargeRaw(COST_EEPROM_READ);
+  return ~eeprom_inverted[eepromAddress(address)];
+}
+
+void eeprom_write_byte(uint8_t *address, uint8_t value) {
+  eeprom_busy_wait();
+  chargeRaw(COST_EEPROM_WRITE);
+  uint16_t a = eepromAddress(address);
+  eeprom_inverted[a] = ~value;
+  eeprom_write_count[a]++;
+  eeprom_ready = sim_now + EEPROM_WRITE_CYCLES;
+}
+
+void eeprom_update_byte(uint8_t *address, uint8_t value) {
+  if(eeprom_read_byte(address) != value) { eeprom_write_byte(address, value); }
+}
+
+void sim::eepromPreset(uint16_t address, uint8_t value) {
+  if(address < EEPROM_SIZE) { eeprom_inverted[address] = ~value; }
+}
+
+uint32_t sim::eepromWrites(uint16_t address) {
+  return (address < EEPROM_SIZE) ? eeprom_write_count[address] : 0;
+}
+
+//################################################################################################################
+// the stand-in for the BitArray library
+//################################################################################################################
+
+BitArrayClass BArray;
@@ -0,0 +1,101 @@
+/*
+ SimCore.h of the simulated Arduino core (host builds only, see tests/Readme.txt)
+
+ The engine behind the simulated core: a virtual clock counting CPU cycles of an ATmega328P @16MHz, the peripherals
+ used by the sketch (timers 0, 1 and 2, ADC, external and pin change interrupts, sleep modes, USART, EEPROM) and the
+ interface to the simulated devices connected to the pins.
+
+ Time only passes, when the code calls a core function (each one is charged with the cycles it takes on the target),
+ when it sleeps and when an interrupt routine runs; the simulation calls "charge" for the code in between (e.g. for
+ each run of "loop"). Whenever the clock passes a point at which a peripheral raises an interrupt flag or a device
+ event is due, it's processed at exactly that point and the interrupt routines are executed as on the target (if
+ their flag and enable bit are set and interrupts are enabled; in the order of their vector numbers).
+
+ Deviations from the target: the phase correct PWM modes count like the normal mode, the USART is modelled by its
+ buffers and line timing only, the analog comparator and the watchdog are not available. A fatal condition (e.g.
+ sleeping with interrupts disabled) ends the simulation with an error message.
+*/
+
+#ifndef SIM_CORE_H_
+#define SIM_CORE_H_
+
+#include <stdint.h>
+
+namespace sim {
+
+// CPU cycles per second and per µs
+const uint32_t CYCLES_PER_SECOND = 16000000;
+const uint32_t CYCLES_PER_US = 16;
+
+// thrown by "charge" when the stop time has been reached (ends "run")
+struct Stop { };
+
+// the virtual time [cycles] since reset
+uint64_t now();
+// lets the given number of cycles pass (processing all events due meanwhile)
+void charge(uint32_t cycles);
+// the time [cycles] at which "run" returns
+void setStopTime(uint64_t time);
+
+// runs the sketch ("init", "setup" and "loop") until the stop time; each run of "loop" is charged with
+// "loop_cycles" in addition to the core functions it calls
+void run(uint32_t loop_cycles);
+
+// ends the simulation with an error message (printf-like)
+void fail(const char *format, ...) __attribute__((noreturn, format(printf, 1, 2)));
+
+//################################################################################################################
+// device interface
+//################################################################################################################
+
+typedef void (*event_fn)(void *ctx);
+// calls "fn" at the given time [cycles]; events due at the same time are called in the order of scheduling
+void schedule(uint64_t time, event_fn fn, void *ctx);
+
+// sets the level of an input pin driven by a device (edges are detected as by the target)
+void setInput(uint8_t pin, uint8_t level);
+
+typedef void (*pin_fn)(void *ctx, uint8_t pin, uint8_t level);
+// registers a function called whenever the level of an output pin changes
+void onPinChange(pin_fn fn, void *ctx);
+
+typedef uint16_t (*adc_fn)(void *ctx, uint8_t channel);
+// sets the function delivering the ADC reading (0...1023) of a channel at the end of a conversion
+void setADCSource(adc_fn fn, void *ctx);
+
+typedef void (*serial_fn)(void *ctx, uint8_t c);
+// sets the function receiving the characters transmitted by the USART (when written into the transmit buffer)
+void setSerialSink(serial_fn fn, void *ctx);
+// puts a character into the USART's receive buffer
+void serialReceive(uint8_t c);
+
+// presets an EEPROM cell (the EEPROM is erased, i.e. 0xFF, at the beginning) and returns the number of writes to it
+void eepromPreset(uint16_t address, uint8_t value);
+uint32_t eepromWrites(uint16_t address);
+
+//################################################################################################################
+// statistics
+//################################################################################################################
+
+// the number of interrupt vectors (avr-libc numbering, vector 0 is the reset)
+const uint8_t VECTORS = 26;
+
+// sets the cycles charged for the body of an interrupt routine in addition to the core functions it calls
+// (entry and exit are charged by the engine)
+void setISRCost(uint8_t vector, uint16_t cycles);
+
+struct isr_stats {
+  uint32_t count; // number of calls
+  uint64_t cycles; // total cycles (including nested core functions and interrupt latency of the engine)
+  uint32_t max; // max. cycles of a single call
+};
+const isr_stats &getISRStats(uint8_t vector);
+
+// the total time [cycles] spent sleeping (all modes) and in power-save mode; the number of wake-ups
+uint64_t sleepCycles();
+uint64_t powerSaveCycles();
+uint32_t wakeUps();
+
+} // namespace sim
+
+#endif // SIM_CORE_H_
@@ -0,0 +1,20 @@
+/*
+ avr/eeprom.h of the simulated Arduino core (host builds only, see tests/Readme.txt)
+
+ 1 KByte of EEPROM; a write takes 3.4ms, during which the EEPROM isn't ready (writes and reads wait for it).
+*/
+
+#ifndef SIM_AVR_EEPROM_H_
+#define SIM_AVR_EEPROM_H_
+
+#include <stdint.h>
+
+#define E2END 0x3FF
+
+int eeprom_is_ready();
+void eeprom_busy_wait();
+uint8_t eeprom_read_byte(const uint8_t *address);
+void eeprom_write_byte(uint8_t *address, uint8_t value);
+void eeprom_update_byte(uint8_t *address, uint8_t value);
+
+#endif // SIM_AVR_EEPROM_H_
@@ -0,0 +1,27 @@
+/*
+ avr/interrupt.h of the simulated Arduino core (host builds only, see tests/Readme.txt)
+
+ An interrupt routine is a plain function with the vector's name; the simulation calls it when its flag and its
+ enable bit are set and interrupts are enabled.
+*/
+
+#ifndef SIM_AVR_INTERRUPT_H_
+#define SIM_AVR_INTERRUPT_H_
+
+#include <avr/io.h>
+
+#ifdef __cplusplus
+#define SIM_ISR_LINKAGE extern "C"
+#else
+#define SIM_ISR_LINKAGE
+#endif
+
+#define ISR(vector, ...) SIM_ISR_LINKAGE void vector(void); SIM_ISR_LINKAGE void vector(void)
+
+void simCli();
+void simSei();
+
+#define cli() simCli()
+#define sei() simSei()
+
+#endif // SIM_AVR_INTERRUPT_H_
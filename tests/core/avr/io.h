@@ -0,0 +1,242 @@
+/*
+ avr/io.h of the simulated Arduino core (host builds only, see tests/Readme.txt)
+
+ The special function registers of the ATmega328P used by the sketch and its libraries. Registers with side
+ effects (SREG, timers, interrupt flags, ADC) are objects calling the simulation on each access; the I/O ports
+ are plain bytes, so that pointers to them can be kept (e.g. "portOutputRegister"). Registers are global by
+ default; a build defining SIM_REG=thread_local gets a private set per thread (used by the benchmarks).
+*/
+
+#ifndef SIM_AVR_IO_H_
+#define SIM_AVR_IO_H_
+
+#include <stdint.h>
+
+#ifndef SIM_REG
+#define SIM_REG
+#endif
+
+//################################################################################################################
+
+// an 8 bit register; the hooks (if any) are called by the simulation on reads and writes, the write hook stores
+// the written value itself (e.g. to implement write-1-to-clear flags)
+class SimReg8 {
+
+public:
+  typedef void (*hook)(SimReg8 &reg, uint8_t written);
+
+  constexpr explicit SimReg8(hook on_read = 0, hook on_write = 0) : value(0), read_hook(on_read),
+                                                                   write_hook(on_write) { }
+
+  operator uint8_t() {
+    if(read_hook) { read_hook(*this, 0); }
+    return value;
+  }
+  SimReg8 &operator=(uint8_t v) {
+    if(write_hook) { write_hook(*this, v); }
+    else { value = v; }
+    return *this;
+  }
+  SimReg8 &operator=(const SimReg8 &) = delete;
+  // int operands (e.g. "~_BV(bit)") are truncated to 8 bit as by avr-gcc
+  SimReg8 &operator|=(int v) { return *this = uint8_t(uint8_t(*this) | v); }
+  SimReg8 &operator&=(int v) { return *this = uint8_t(uint8_t(*this) & v); }
+  SimReg8 &operator^=(int v) { return *this = uint8_t(uint8_t(*this) ^ v); }
+
+  uint8_t value;
+  hook read_hook;
+  hook write_hook;
+};
+
+// a 16 bit register (accessed as a whole; the temporary high byte register isn't modelled)
+class SimReg16 {
+
+public:
+  typedef void (*hook)(SimReg16 &reg, uint16_t written);
+
+  constexpr explicit SimReg16(hook on_read = 0, hook on_write = 0) : value(0), read_hook(on_read),
+                                                                    write_hook(on_write) { }
+
+  operator uint16_t() {
+    if(read_hook) { read_hook(*this, 0); }
+    return value;
+  }
+  SimReg16 &operator=(uint16_t v) {
+    if(write_hook) { write_hook(*this, v); }
+    else { value = v; }
+    return *this;
+  }
+  SimReg16 &operator=(const SimReg16 &) = delete;
+
+  uint16_t value;
+  hook read_hook;
+  hook write_hook;
+};
+
+//################################################################################################################
+// registers
+//################################################################################################################
+
+// I/O ports
+extern SIM_REG volatile uint8_t PINB, DDRB, PORTB, PINC, DDRC, PORTC, PIND, DDRD, PORTD;
+
+// status register, sleep mode control, general timer control
+extern SIM_REG SimReg8 SREG, SMCR, GTCCR;
+
+// external and pin change interrupts
+extern SIM_REG SimReg8 EICRA, EIMSK, EIFR, PCICR, PCIFR, PCMSK0, PCMSK1, PCMSK2;
+
+// timer 0
+extern SIM_REG SimReg8 TCCR0A, TCCR0B, TCNT0, OCR0A, OCR0B, TIMSK0, TIFR0;
+
+// timer 1
+extern SIM_REG SimReg8 TCCR1A, TCCR1B, TCCR1C, TIMSK1, TIFR1;
+extern SIM_REG SimReg16 TCNT1, OCR1A, OCR1B, ICR1;
+
+// timer 2
+extern SIM_REG SimReg8 TCCR2A, TCCR2B, TCNT2, OCR2A, OCR2B, TIMSK2, TIFR2, ASSR;
+
+// ADC and analog comparator
+extern SIM_REG SimReg8 ADMUX, ADCSRA, ADCSRB, DIDR0, ACSR;
+extern SIM_REG SimReg16 ADC;
+
+//################################################################################################################
+// bits
+//################################################################################################################
+
+#define _BV(bit) (1 << (bit))
+
+// SREG
+#define SREG_I 7
+
+// SMCR
+#define SE 0
+#define SM0 1
+#define SM1 2
+#define SM2 3
+
+// GTCCR
+#define PSRSYNC 0
+#define PSRASY 1
+#define TSM 7
+
+// EICRA, EIMSK, EIFR
+#define ISC00 0
+#define ISC01 1
+#define ISC10 2
+#define ISC11 3
+#define INT0 0
+#define INT1 1
+#define INTF0 0
+#define INTF1 1
+
+// PCICR, PCIFR
+#define PCIE0 0
+#define PCIE1 1
+#define PCIE2 2
+#define PCIF0 0
+#define PCIF1 1
+#define PCIF2 2
+
+// timer 0
+#define WGM00 0
+#define WGM01 1
+#define WGM02 3
+#define CS00 0
+#define CS01 1
+#define CS02 2
+#define TOIE0 0
+#define OCIE0A 1
+#define OCIE0B 2
+#define TOV0 0
+#define OCF0A 1
+#define OCF0B 2
+
+// timer 1
+#define WGM10 0
+#define WGM11 1
+#define WGM12 3
+#define WGM13 4
+#define ICES1 6
+#define ICNC1 7
+#define CS10 0
+#define CS11 1
+#define CS12 2
+#define TOIE1 0
+#define OCIE1A 1
+#define OCIE1B 2
+#define ICIE1 5
+#define TOV1 0
+#define OCF1A 1
+#define OCF1B 2
+#define ICF1 5
+
+// timer 2
+#define WGM20 0
+#define WGM21 1
+#define WGM22 3
+#define COM2B0 4
+#define COM2B1 5
+#define COM2A0 6
+#define COM2A1 7
+#define CS20 0
+#define CS21 1
+#define CS22 2
+#define TOIE2 0
+#define OCIE2A 1
+#define OCIE2B 2
+#define TOV2 0
+#define OCF2A 1
+#define OCF2B 2
+
+// ADC
+#define MUX0 0
+#define MUX1 1
+#define MUX2 2
+#define MUX3 3
+#define ADLAR 5
+#define REFS0 6
+#define REFS1 7
+#define ADPS0 0
+#define ADPS1 1
+#define ADPS2 2
+#define ADIE 3
+#define ADIF 4
+#define ADATE 5
+#define ADSC 6
+#define ADEN 7
+
+// analog comparator
+#define ACIS0 0
+#define ACIS1 1
+#define ACIC 2
+#define ACIE 3
+#define ACI 4
+#define ACO 5
+#define ACBG 6
+#define ACD 7
+
+//################################################################################################################
+// interrupt vectors (numbered as by avr-libc)
+//################################################################################################################
+
+#define INT0_vect __vector_1
+#define INT1_vect __vector_2
+#define PCINT0_vect __vector_3
+#define PCINT1_vect __vector_4
+#define PCINT2_vect __vector_5
+#define WDT_vect __vector_6
+#define TIMER2_COMPA_vect __vector_7
+#define TIMER2_COMPB_vect __vector_8
+#define TIMER2_OVF_vect __vector_9
+#define TIMER1_CAPT_vect __vector_10
+#define TIMER1_COMPA_vect __vector_11
+#define TIMER1_COMPB_vect __vector_12
+#define TIMER1_OVF_vect __vector_13
+#define TIMER0_COMPA_vect __vector_14
+#define TIMER0_COMPB_vect __vector_15
+#define TIMER0_OVF_vect __vector_16
+#define ADC_vect __vector_21
+#define ANALOG_COMP_vect __vector_23
+
+#endif // SIM_AVR_IO_H_
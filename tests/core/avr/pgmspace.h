@@ -0,0 +1,31 @@
+/*
+ avr/pgmspace.h of the simulated Arduino core (host builds only, see tests/Readme.txt)
+
+ There is only one address space on the host; PROGMEM data is read directly.
+*/
+
+#ifndef SIM_AVR_PGMSPACE_H_
+#define SIM_AVR_PGMSPACE_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#define PROGMEM
+#define PGM_P const char *
+#define PSTR(s) (s)
+
+#define pgm_read_byte_near(address) (*(const uint8_t *) (address))
+#define pgm_read_word_near(address) (*(const uint16_t *) (address))
+#define pgm_read_dword_near(address) (*(const uint32_t *) (address))
+#define pgm_read_byte(address) pgm_read_byte_near(address)
+#define pgm_read_word(address) pgm_read_word_near(address)
+#define pgm_read_dword(address) pgm_read_dword_near(address)
+#define pgm_read_ptr(address) (*(void * const *) (address))
+
+#define memcpy_P memcpy
+#define strcpy_P strcpy
+#define strncpy_P strncpy
+#define strlen_P strlen
+#define strcmp_P strcmp
+
+#endif // SIM_AVR_PGMSPACE_H_
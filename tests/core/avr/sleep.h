@@ -0,0 +1,25 @@
+/*
+ avr/sleep.h of the simulated Arduino core (host builds only, see tests/Readme.txt)
+*/
+
+#ifndef SIM_AVR_SLEEP_H_
+#define SIM_AVR_SLEEP_H_
+
+#include <avr/io.h>
+
+#define SLEEP_MODE_IDLE (0)
+#define SLEEP_MODE_ADC _BV(SM0)
+#define SLEEP_MODE_PWR_DOWN _BV(SM1)
+#define SLEEP_MODE_PWR_SAVE (_BV(SM0) | _BV(SM1))
+#define SLEEP_MODE_STANDBY (_BV(SM1) | _BV(SM2))
+#define SLEEP_MODE_EXT_STANDBY (_BV(SM0) | _BV(SM1) | _BV(SM2))
+
+void simSleep();
+
+#define set_sleep_mode(mode) (SMCR = (SMCR & ~(_BV(SM0) | _BV(SM1) | _BV(SM2))) | (mode))
+#define sleep_enable() (SMCR |= _BV(SE))
+#define sleep_disable() (SMCR &= ~_BV(SE))
+#define sleep_cpu() simSleep()
+#define sleep_mode() do { sleep_enable(); sleep_cpu(); sleep_disable(); } while(0)
+
+#endif // SIM_AVR_SLEEP_H_
@@ -0,0 +1,27 @@
+/*
+ limits.h of the simulated Arduino core (host builds only, see tests/Readme.txt)
+
+ The host's limits with those of "int" and "long" replaced by the target's values (16 and 32 bit), as the sketch
+ computes with them (e.g. "LONG_MIN>>1" assigned to an int32_t).
+*/
+
+#ifndef SIM_LIMITS_H_
+#define SIM_LIMITS_H_
+
+#include_next <limits.h>
+
+#undef INT_MAX
+#undef INT_MIN
+#undef UINT_MAX
+#undef LONG_MAX
+#undef LONG_MIN
+#undef ULONG_MAX
+
+#define INT_MAX 0x7FFF
+#define INT_MIN (-INT_MAX - 1)
+#define UINT_MAX 0xFFFFU
+#define LONG_MAX 0x7FFFFFFFL
+#define LONG_MIN (-LONG_MAX - 1L)
+#define ULONG_MAX 0xFFFFFFFFUL
+
+#endif // SIM_LIMITS_H_
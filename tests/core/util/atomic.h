@@ -0,0 +1,26 @@
+/*
+ util/atomic.h of the simulated Arduino core (host builds only, see tests/Readme.txt)
+
+ The same construction as avr-libc's: the state is restored by a cleanup function when the block is left.
+*/
+
+#ifndef SIM_UTIL_ATOMIC_H_
+#define SIM_UTIL_ATOMIC_H_
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+static inline uint8_t __iCliRetVal() { cli(); return 1; }
+static inline void __iSeiParam(const uint8_t *) { sei(); }
+static inline void __iCliParam(const uint8_t *) { cli(); }
+static inline void __iRestore(const uint8_t *sreg) { SREG = *sreg; }
+
+#define ATOMIC_BLOCK(type) for(type, __ToDo = __iCliRetVal(); __ToDo; __ToDo = 0)
+#define NONATOMIC_BLOCK(type) for(type, __ToDo = (sei(), 1); __ToDo; __ToDo = 0)
+
+#define ATOMIC_RESTORESTATE uint8_t sreg_save __attribute__((__cleanup__(__iRestore))) = SREG
+#define ATOMIC_FORCEON uint8_t sreg_save __attribute__((__cleanup__(__iSeiParam))) = 0
+#define NONATOMIC_RESTORESTATE uint8_t sreg_save __attribute__((__cleanup__(__iRestore))) = SREG
+#define NONATOMIC_FORCEOFF uint8_t sreg_save __attribute__((__cleanup__(__iCliParam))) = 0
+
+#endif // SIM_UTIL_ATOMIC_H_
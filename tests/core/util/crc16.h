@@ -0,0 +1,22 @@
+/*
+ util/crc16.h of the simulated Arduino core (host builds only, see tests/Readme.txt)
+
+ The C equivalent of avr-libc's "_crc_ibutton_update" given in its documentation.
+*/
+
+#ifndef SIM_UTIL_CRC16_H_
+#define SIM_UTIL_CRC16_H_
+
+#include <stdint.h>
+
+static inline uint8_t _crc_ibutton_update(uint8_t crc, uint8_t data) {
+  crc = crc ^ data;
+  for(uint8_t i=0; i<8; i++) {
+    if(crc & 0x01) { crc = (crc >> 1) ^ 0x8C; }
+    else { crc >>= 1; }
+  }
+
+  return crc;
+}
+
+#endif // SIM_UTIL_CRC16_H_
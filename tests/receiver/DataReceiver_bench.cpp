@@ -0,0 +1,464 @@
+/*
+ DataReceiver_bench.cpp (host builds only, see tests/Readme.txt)
+
+ Runs library "DataReceiver" (pin change front end, as used by WSPRduino2) on streams of edges and measures how
+ many datasets it receives and how long its isr takes per edge, over a sweep of link conditions:
+  - the GPS-module sends the datasets of GPS_beacon (position/time and astro data, alternating, random contents),
+    Manchester-coded step by step by ManchesterEncoder (the state machine of DataTransmitterClass::isr) at a
+    given byte rate, with or without forward error correction, separated by an idle gap
+  - the link: clock error of the transmitter (skew), jitter of each edge (uniform, e.g. interrupt latency),
+    dropouts (the input stuck for some time, e.g. a fade) and glitches (spikes toggling the input)
+  - the receiver: the isr is called for each edge with "micros" returning its time (4μs granularity), the
+    datasets received are handed over by "dispatch" before the next one is sent and compared with those sent
+
+ Each combination of the values given (comma separated lists) is one point of the sweep; the points are run by
+ a pool of threads, each with its own receiver (see mock/Arduino.h). For each point the table shows the datasets
+ hit by a dropout or glitch, received correctly, lost and corrupted (passed the CRC with wrong contents), the
+ receiver's counters per dataset sent and the host CPU cycles per call of the isr (mean and 99.9% quantile; the
+ time stamp counter on x86, otherwise ns). The cycles of the target have to be measured on the ATmega itself.
+
+ With "--check" a fixed set of points is run instead; at each of them all datasets not hit by a dropout or glitch
+ have to be received and none may be corrupted. Exit status: 0 if all checks passed, 1 if one failed, 2 on
+ invalid options.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include <ManchesterEncoder.h>
+#include <GPSDatasets.h>
+// (the bench calls the pin change isr of its own receiver: the static "isr" attached to the interrupt serves the
+// instance initialized last, which is not the thread's own)
+#define private public
+#include <DataReceiver.h>
+#undef private
+
+namespace mock {
+  thread_local uint64_t now_ns = 0;
+  thread_local uint8_t level = 0;
+  thread_local void (*isr)() = 0;
+  thread_local uint8_t sreg = 0x80;
+}
+
+namespace {
+
+//################################################################################################################
+// options
+//################################################################################################################
+
+struct {
+  std::vector<double> rates = {30};
+  std::vector<double> fec = {0};
+  std::vector<double> jitter_us = {0};
+  std::vector<double> skew_ppm = {0};
+  std::vector<double> dropouts = {0}; // per dataset
+  std::vector<double> glitches = {0}; // per dataset (mean)
+  double dropout_ms = 5;
+  double glitch_us = 10;
+  double gap_ms = 50;
+  uint32_t frames = 20000;
+  uint8_t fixed_rate = 0;
+  unsigned threads = 0;
+  uint32_t seed = 1;
+  uint8_t check = 0;
+} opt;
+
+void usage() {
+  printf("usage: DataReceiver_bench [options] (LIST: comma separated values, each one a point of the sweep)\n"
+         "  --frames N         datasets sent per point (default 20000)\n"
+         "  --rate LIST        byte rate of the transmitter (4...255, default 30 as GPS_beacon)\n"
+         "  --fixed            receiver set to the transmitter's byte rate (default: detected, as WSPRduino2)\n"
+         "  --fec LIST         0 -> plain datasets, 1 -> forward error correction (default 0)\n"
+         "  --jitter LIST      max. jitter [us] of each edge (uniform, default 0)\n"
+         "  --skew LIST        clock error [ppm] of the transmitter (default 0)\n"
+         "  --dropout LIST     probability of a dropout per dataset (default 0)\n"
+         "  --dropout-ms MS    length of a dropout (default 5)\n"
+         "  --glitch LIST      mean number of glitches per dataset (default 0)\n"
+         "  --glitch-us US     max. width of a glitch (default 10)\n"
+         "  --gap MS           idle time between two datasets (default 50)\n"
+         "  --threads N        threads running the points (default: number of CPUs)\n"
+         "  --seed N           seed of the random numbers (each point has its own sequence)\n"
+         "  --check            run the fixed set of points of \"make check\" and check the results\n");
+  exit(2);
+}
+
+std::vector<double> parseList(const char *s) {
+  std::vector<double> list;
+  while(*s) {
+    char *end;
+    list.push_back(strtod(s, &end));
+    if(end == s) { usage(); }
+    s = (*end == ',') ? end + 1 : end;
+  }
+  if(list.empty()) { usage(); }
+  return list;
+}
+
+void parseOptions(int argc, char **argv) {
+  for(int i=1; i<argc; i++) {
+    const char *a = argv[i];
+    const char *v = (i + 1 < argc) ? argv[i + 1] : 0;
+    auto value = [&]() { if(!v) { usage(); } ++i; return v; };
+
+    if(!strcmp(a, "--frames")) { opt.frames = strtoul(value(), 0, 0); }
+    else if(!strcmp(a, "--rate")) { opt.rates = parseList(value()); }
+    else if(!strcmp(a, "--fixed")) { opt.fixed_rate = 1; }
+    else if(!strcmp(a, "--fec")) { opt.fec = parseList(value()); }
+    else if(!strcmp(a, "--jitter")) { opt.jitter_us = parseList(value()); }
+    else if(!strcmp(a, "--skew")) { opt.skew_ppm = parseList(value()); }
+    else if(!strcmp(a, "--dropout")) { opt.dropouts = parseList(value()); }
+    else if(!strcmp(a, "--dropout-ms")) { opt.dropout_ms = atof(value()); }
+    else if(!strcmp(a, "--glitch")) { opt.glitches = parseList(value()); }
+    else if(!strcmp(a, "--glitch-us")) { opt.glitch_us = atof(value()); }
+    else if(!strcmp(a, "--gap")) { opt.gap_ms = atof(value()); }
+    else if(!strcmp(a, "--threads")) { opt.threads = strtoul(value(), 0, 0); }
+    else if(!strcmp(a, "--seed")) { opt.seed = strtoul(value(), 0, 0); }
+    else if(!strcmp(a, "--check")) { opt.check = 1; }
+    else { usage(); } // (also "--help")
+  }
+  for(double r : opt.rates) {
+    if(r < 4 || r > 255) { usage(); }
+  }
+}
+
+//################################################################################################################
+// time measurement of the isr
+//################################################################################################################
+
+#if defined(__x86_64__) || defined(__i386__)
+const char *TICK_UNIT = "cycles";
+#else
+const char *TICK_UNIT = "ns";
+#endif
+
+inline uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// the ticks of an empty measurement (subtracted from each one)
+uint64_t tick_overhead = 0;
+
+void calibrate() {
+  uint64_t best = ~0ULL;
+  for(uint16_t i=0; i<10000; i++) {
+    uint64_t t0 = ticks();
+    uint64_t t1 = ticks();
+    best = std::min(best, t1 - t0);
+  }
+  tick_overhead = best;
+}
+
+// the ticks per call in classes of 1/4 octave (for the quantile)
+const uint16_t TICK_CLASSES = 128;
+
+uint16_t tickClass(uint64_t t) {
+  if(t < 4) { return t; }
+  uint8_t octave = 63 - __builtin_clzll(t);
+  uint16_t c = 4*(octave - 1) + ((t >> (octave - 2)) & 3);
+  return std::min<uint16_t>(c, TICK_CLASSES - 1);
+}
+
+double classValue(uint16_t c) {
+  if(c < 4) { return c; }
+  uint8_t octave = c/4 + 1;
+  return ldexp(1.0 + 0.25*(c & 3) + 0.125, octave);
+}
+
+//################################################################################################################
+// a point of the sweep
+//################################################################################################################
+
+struct point {
+  uint8_t rate;
+  uint8_t fec;
+  double jitter_us;
+  double skew_ppm;
+  double dropout;
+  double glitches;
+};
+
+struct result {
+  uint64_t frames = 0;
+  uint64_t received = 0;
+  uint64_t corrupted = 0;
+  uint64_t disturbed = 0; // datasets hit by a dropout or a glitch
+  uint64_t counters[8] = {}; // the counters of dr_stats up to "delivered"
+  uint64_t edges = 0;
+  uint64_t isr_ticks = 0;
+  uint64_t tick_classes[TICK_CLASSES] = {};
+  double seconds = 0; // time taken (host)
+};
+
+// the receiver of a thread and the dataset just sent (for the processing function)
+struct bench_receiver {
+  DataReceiverClass rx;
+  dset_r datasets[2];
+  uint8_t buffer[drBufferSize(2, fecEncodedSize(GPS_DATASETS_MAX_SIZE))];
+  const uint8_t *sent;
+  uint8_t sent_size;
+  result *res;
+};
+
+thread_local bench_receiver *current = 0;
+
+void datasetReceived() {
+  bench_receiver &b = *current;
+  if(!memcmp(b.rx.getDataArray(), b.sent, b.sent_size)) { b.res->received++; }
+  else { b.res->corrupted++; }
+}
+
+void collectCounters(bench_receiver &b) {
+  dr_stats st;
+  b.rx.getStats(&st);
+  b.rx.resetStats();
+  const uint16_t *c = &st.preambles;
+  for(uint8_t i=0; i<8; i++) { b.res->counters[i] += c[i]; }
+}
+
+// one dataset from its first step to the end of the idle gap following it: the edges of the transmitter are
+// generated, disturbed and fed to the isr one by one
+void sendDataset(bench_receiver &b, const point &p, std::mt19937_64 &rng, uint64_t &t_ns, uint8_t &line,
+                 std::vector<int64_t> &edges, std::vector<int64_t> &disturbed) {
+  static const uint8_t SIZES[2] = {sizeof(gps_dataset), sizeof(astro_dataset)};
+  static const uint8_t IDS[2] = {GPS_DATASET_ID, ASTRO_DATASET_ID};
+  uint8_t type = b.res->frames & 1;
+  uint8_t data[GPS_DATASETS_MAX_SIZE];
+  for(uint8_t i=0; i<SIZES[type]; i++) { data[i] = rng(); }
+  b.sent = data;
+  b.sent_size = SIZES[type];
+
+  // the edges of the transmitter
+  ManchesterEncoder encoder;
+  encoder.start(IDS[type] | (p.fec ? FEC_FLAG : 0), data, SIZES[type]);
+  double step_ns = ManchesterEncoder::stepCycles(p.rate)*62.5*(1 + p.skew_ppm*1e-6);
+  double t = t_ns;
+  edges.clear();
+  do {
+    t += step_ns;
+    uint8_t level = encoder.step();
+    if(level != line) {
+      edges.push_back(int64_t(t));
+      line = level;
+    }
+  }
+  while(encoder.busy());
+  int64_t end = int64_t(t);
+
+  // dropout: no edges for "dropout_ms" starting anywhere within the dataset; the input returns to the
+  // transmitter's level at its end
+  std::uniform_real_distribution<double> uniform(0, 1);
+  uint8_t hit = 0;
+  if(p.dropout > 0 && uniform(rng) < p.dropout) {
+    hit = 1;
+    int64_t from = t_ns + int64_t(uniform(rng)*(end - int64_t(t_ns)));
+    int64_t to = from + int64_t(opt.dropout_ms*1e6);
+    auto first = std::lower_bound(edges.begin(), edges.end(), from);
+    auto last = std::lower_bound(edges.begin(), edges.end(), to);
+    uint8_t odd = (last - first) & 1;
+    last = edges.erase(first, last);
+    if(odd) { edges.insert(last, to); }
+  }
+
+  // jitter of each edge (the order of the edges is kept)
+  if(p.jitter_us > 0) {
+    std::uniform_real_distribution<double> jitter(-p.jitter_us*1000, p.jitter_us*1000);
+    for(size_t i=0; i<edges.size(); i++) {
+      edges[i] += int64_t(jitter(rng));
+      if(i && edges[i] < edges[i - 1]) { edges[i] = edges[i - 1]; }
+    }
+  }
+
+  // glitches: spikes of up to "glitch_us" anywhere within the dataset (the input is the transmitter's level
+  // xor the spikes, so their edges simply add to those of the transmitter)
+  disturbed = edges;
+  if(p.glitches > 0) {
+    std::poisson_distribution<uint32_t> count(p.glitches);
+    uint32_t n = count(rng);
+    hit |= (n > 0);
+    for(; n; n--) {
+      int64_t at = t_ns + int64_t(uniform(rng)*(end - int64_t(t_ns)));
+      disturbed.push_back(at);
+      disturbed.push_back(at + 1000 + int64_t(uniform(rng)*(opt.glitch_us - 1)*1000));
+    }
+    std::sort(disturbed.begin(), disturbed.end());
+  }
+
+  // the receiver
+  for(int64_t e : disturbed) {
+    mock::now_ns = e;
+    uint64_t t0 = ticks();
+    b.rx.DRisr();
+    uint64_t dt = ticks() - t0;
+    dt = (dt > tick_overhead) ? dt - tick_overhead : 0;
+    b.res->isr_ticks += dt;
+    b.res->tick_classes[tickClass(dt)]++;
+  }
+  b.res->edges += disturbed.size();
+  b.res->disturbed += hit;
+
+  // the main loop hands the dataset over after the gap
+  t_ns = end + uint64_t(opt.gap_ms*1e6);
+  mock::now_ns = t_ns;
+  b.rx.dispatch();
+  b.res->frames++;
+}
+
+void runPoint(const point &p, uint32_t index, result &res) {
+  auto start = std::chrono::steady_clock::now();
+  std::mt19937_64 rng(opt.seed*1000003ULL + index);
+
+  bench_receiver *b = new bench_receiver;
+  current = b;
+  b->res = &res;
+  uint8_t fec = p.fec ? FEC_FLAG : 0;
+  b->datasets[0] = b->rx.createDataset(GPS_DATASET_ID | fec, sizeof(gps_dataset), datasetReceived);
+  b->datasets[1] = b->rx.createDataset(ASTRO_DATASET_ID | fec, sizeof(astro_dataset), datasetReceived);
+  b->rx.init(opt.fixed_rate ? p.rate : DR_AUTO_BAUD, 2, b->datasets, 2, b->buffer, sizeof(b->buffer));
+
+  // (the receiver's clock starts at a random time, so micros() wraps within the first 71 minutes)
+  uint64_t t_ns = rng() % 4294967296000ULL;
+  mock::now_ns = t_ns;
+  uint8_t line = 0;
+  std::vector<int64_t> edges, disturbed;
+  for(uint32_t f=0; f<opt.frames; f++) {
+    sendDataset(*b, p, rng, t_ns, line, edges, disturbed);
+    // (the counters saturate at 65535)
+    if((f & 255) == 255) { collectCounters(*b); }
+  }
+  collectCounters(*b);
+
+  current = 0;
+  delete b;
+  res.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double quantile(const result &r, double q) {
+  uint64_t total = 0;
+  for(uint16_t c=0; c<TICK_CLASSES; c++) { total += r.tick_classes[c]; }
+  uint64_t sum = 0;
+  for(uint16_t c=0; c<TICK_CLASSES; c++) {
+    sum += r.tick_classes[c];
+    if(sum >= q*total) { return classValue(c); }
+  }
+  return 0;
+}
+
+void printHeader() {
+  printf("rate fec jitter   skew  drop glitch |   frames     hit  received     lost  corrupt | preamb short  long"
+         "   crc   fec | edges %s/edge (99.9%%)\n", TICK_UNIT);
+}
+
+void printResult(const point &p, const result &r) {
+  double f = r.frames ? double(r.frames) : 1;
+  uint64_t lost = r.frames - r.received - r.corrupted;
+  printf("%4u %3u %5.1fus %6.0f %5.3f %6.2f | %8llu %6.2f%% %8.4f%% %7.4f%% %8llu | %6.2f %5.2f %5.2f %5.3f %5.2f | "
+         "%5.1f %5.1f (%.0f)\n", p.rate, p.fec, p.jitter_us, p.skew_ppm, p.dropout, p.glitches,
+         (unsigned long long) r.frames, 100*r.disturbed/f, 100*r.received/f, 100*lost/f, (unsigned long long) r.corrupted,
+         r.counters[0]/f, r.counters[1]/f, r.counters[2]/f, r.counters[5]/f, r.counters[6]/f, r.edges/f,
+         r.edges ? double(r.isr_ticks)/r.edges : 0, quantile(r, 0.999));
+}
+
+// runs the points on a pool of threads
+void runPoints(const std::vector<point> &points, std::vector<result> &results) {
+  results.assign(points.size(), result());
+  std::atomic<uint32_t> next(0);
+  auto worker = [&]() {
+    for(uint32_t i; (i = next++) < points.size(); ) { runPoint(points[i], i, results[i]); }
+  };
+
+  unsigned n = opt.threads ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+  n = std::min<unsigned>(n, points.size());
+  std::vector<std::thread> pool;
+  for(unsigned i=1; i<n; i++) { pool.emplace_back(worker); }
+  worker();
+  for(std::thread &t : pool) { t.join(); }
+}
+
+//################################################################################################################
+// the points of "--check" and their limits
+//################################################################################################################
+
+const point CHECKS[] = {
+  // undisturbed at the lowest, the GPS-module's and the highest byte rate, with and without FEC
+  {4, 0, 0, 0, 0, 0},
+  {30, 0, 0, 0, 0, 0},
+  {30, 1, 0, 0, 0, 0},
+  {255, 0, 0, 0, 0, 0},
+  // jitter and clock errors (a ceramic resonator: 0.5%)
+  {30, 0, 20, 5000, 0, 0},
+  {30, 0, 20, -5000, 0, 0},
+  {255, 0, 4, 5000, 0, 0},
+  // dropouts and glitches: each one may cost the dataset it hits, but not the following one
+  {30, 0, 4, 0, 0.1, 0},
+  {30, 0, 4, 0, 0, 0.1},
+  {30, 1, 4, 0, 0, 0.1},
+};
+
+} // namespace
+
+int main(int argc, char **argv) {
+  parseOptions(argc, argv);
+  calibrate();
+
+  std::vector<point> points;
+  if(opt.check) {
+    points.assign(CHECKS, CHECKS + sizeof(CHECKS)/sizeof(CHECKS[0]));
+    if(opt.frames > 5000) { opt.frames = 5000; }
+  }
+  else {
+    for(double r : opt.rates) {
+      for(double f : opt.fec) {
+        for(double j : opt.jitter_us) {
+          for(double s : opt.skew_ppm) {
+            for(double d : opt.dropouts) {
+              for(double g : opt.glitches) { points.push_back({uint8_t(r), uint8_t(f != 0), j, s, d, g}); }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  std::vector<result> results;
+  auto start = std::chrono::steady_clock::now();
+  runPoints(points, results);
+  double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  printHeader();
+  uint32_t failures = 0;
+  uint64_t frames = 0;
+  for(size_t i=0; i<points.size(); i++) {
+    printResult(points[i], results[i]);
+    frames += results[i].frames;
+    const result &r = results[i];
+    if(opt.check && (r.received + r.disturbed < r.frames || r.corrupted)) {
+      printf("FAILED: %llu of %llu datasets not hit by a dropout or glitch lost, %llu corrupted\n",
+             (unsigned long long) (r.frames - r.disturbed - std::min(r.received, r.frames - r.disturbed)),
+             (unsigned long long) (r.frames - r.disturbed), (unsigned long long) r.corrupted);
+      ++failures;
+    }
+  }
+  printf("%llu datasets in %.1fs (%.0f per second)\n", (unsigned long long) frames, wall, frames/wall);
+
+  if(opt.check) {
+    printf("%s\n", failures ? "FAILED" : "PASSED");
+    return failures ? 1 : 0;
+  }
+  return 0;
+}
@@ -0,0 +1,62 @@
+/*
+ Arduino.h of the receiver bench (host builds only, see tests/Readme.txt)
+
+ The few core functions library "DataReceiver" uses with the pin change front end, as stand-ins whose state is
+ kept per thread, so that each thread of the bench can run its own receiver: "micros" returns the time set by the
+ bench (4μs granularity as on the target @16MHz), "attachInterrupt" keeps the function passed, SREG and "cli"
+ only record the interrupt flag. The timer 1 input capture front end is not available (no __AVR_ATmega328P__).
+*/
+
+#ifndef RECEIVER_MOCK_ARDUINO_H_
+#define RECEIVER_MOCK_ARDUINO_H_
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <avr/pgmspace.h>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define NOT_AN_INTERRUPT -1
+#define digitalPinToInterrupt(P) ((P) == 2 ? 0 : ((P) == 3 ? 1 : NOT_AN_INTERRUPT))
+
+// the same semantics as the macros of the AVR core (the result has the common type of both arguments)
+template<class T, class L> inline auto min(const T &a, const L &b) -> decltype((b < a) ? b : a) {
+  return (b < a) ? b : a;
+}
+template<class T, class L> inline auto max(const T &a, const L &b) -> decltype((b < a) ? b : a) {
+  return (a < b) ? b : a;
+}
+
+namespace mock {
+  extern thread_local uint64_t now_ns; // the time of the thread's receiver
+  extern thread_local uint8_t level; // the level at the receiver's input
+  extern thread_local void (*isr)(); // the function attached to the input's interrupt (0 -> none)
+  extern thread_local uint8_t sreg;
+}
+
+#define SREG (mock::sreg)
+inline void cli() { mock::sreg &= ~0x80; }
+inline void sei() { mock::sreg |= 0x80; }
+
+inline unsigned long micros() { return uint32_t(mock::now_ns/1000) & ~3UL; }
+inline unsigned long millis() { return uint32_t(mock::now_ns/1000000); }
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline int digitalRead(uint8_t) { return mock::level; }
+inline void attachInterrupt(uint8_t, void (*userFunc)(void), int) { mock::isr = userFunc; }
+inline void detachInterrupt(uint8_t) { mock::isr = 0; }
+
+#endif // RECEIVER_MOCK_ARDUINO_H_
@@ -0,0 +1,7 @@
+/*
+ avr/pgmspace.h of the receiver bench (host builds only, see tests/Readme.txt)
+
+ The one of the simulated Arduino core (the core's directory is not searched, as it replaces limits.h).
+*/
+
+#include "../../../core/avr/pgmspace.h"
@@ -0,0 +1,47 @@
+/*
+ AD9850Model.cpp (host builds only, see tests/Readme.txt)
+*/
+
+#include <SimCore.h>
+#include "AD9850Model.h"
+
+AD9850Model::AD9850Model(uint8_t w_clk_pin, uint8_t fq_ud_pin, uint8_t data_pin, uint8_t reset_pin)
+  : w_clk(w_clk_pin), fq_ud(fq_ud_pin), data(data_pin), reset(reset_pin) { }
+
+void AD9850Model::attach(update_fn fn, void *ctx) {
+  listener = fn;
+  listener_ctx = ctx;
+  sim::onPinChange(pinChanged, this);
+}
+
+void AD9850Model::pinChanged(void *ctx, uint8_t pin, uint8_t level) {
+  AD9850Model &m = *(AD9850Model *) ctx;
+
+  if(pin == m.data) { m.data_level = level; }
+  else if(!level) { return; }
+  else if(pin == m.reset) {
+    m.input = 0;
+    m.serial = 0;
+    m.w_clk_seen = 0;
+    m.latch(1);
+  }
+  else if(pin == m.w_clk) {
+    if(m.serial) { m.input = (m.input >> 1) | (uint64_t(m.data_level) << 39); }
+    else { m.w_clk_seen = 1; }
+  }
+  else if(pin == m.fq_ud) {
+    if(m.serial) { m.latch(0); }
+    else if(m.w_clk_seen) { m.serial = 1; }
+  }
+}
+
+void AD9850Model::latch(uint8_t reset) {
+  uint8_t control = input >> 32;
+  out.time = sim::now();
+  out.word = uint32_t(input);
+  out.phase = control >> 3;
+  out.power_down = (control >> 2) & 1;
+  out.reset = reset;
+  ++update_count;
+  if(listener) { listener(listener_ctx, out); }
+}
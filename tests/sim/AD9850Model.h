@@ -0,0 +1,52 @@
+/*
+ AD9850Model.h (host builds only, see tests/Readme.txt)
+
+ The serial interface of an AD9850 DDS as seen at its pins W_CLK, FQ_UD, DATA and RESET: the 40 bit input
+ register shifts at each rising edge of W_CLK (LSB first), the rising edge of FQ_UD transfers it to the frequency
+ (bits 0...31) and control/phase (bits 32...39) registers. RESET clears the registers and selects the parallel
+ mode; a W_CLK pulse followed by an FQ_UD pulse enables the serial mode again (with the serial mode strapping at
+ D0...D2 of the module). Each update of the output is reported to a listener.
+*/
+
+#ifndef AD9850_MODEL_H_
+#define AD9850_MODEL_H_
+
+#include <stdint.h>
+
+class AD9850Model {
+
+public:
+  struct update {
+    uint64_t time; // [cycles]
+    uint32_t word; // frequency tuning word
+    uint8_t phase; // 5 bit phase
+    uint8_t power_down;
+    uint8_t reset; // the update was caused by RESET
+  };
+  typedef void (*update_fn)(void *ctx, const update &u);
+
+  AD9850Model(uint8_t w_clk_pin, uint8_t fq_ud_pin, uint8_t data_pin, uint8_t reset_pin);
+  // connects the model to the simulation's pins
+  void attach(update_fn fn, void *ctx);
+
+  // the output is active (the tuning word is applied and the DDS is not powered down)
+  uint8_t isOn() const { return out.word && !out.power_down; }
+  const update &output() const { return out; }
+  uint32_t updates() const { return update_count; }
+
+private:
+  static void pinChanged(void *ctx, uint8_t pin, uint8_t level);
+  void latch(uint8_t reset);
+
+  uint8_t w_clk, fq_ud, data, reset;
+  uint8_t data_level = 0;
+  uint8_t serial = 0;
+  uint8_t w_clk_seen = 0;
+  uint64_t input = 0;
+  update out = {0, 0, 0, 0, 0};
+  uint32_t update_count = 0;
+  update_fn listener = 0;
+  void *listener_ctx = 0;
+};
+
+#endif // AD9850_MODEL_H_
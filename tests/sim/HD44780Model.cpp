@@ -0,0 +1,122 @@
+/*
+ HD44780Model.cpp (host builds only, see tests/Readme.txt)
+*/
+
+#include <string.h>
+
+#include <SimCore.h>
+#include "HD44780Model.h"
+
+// the execution times [cycles]
+const uint64_t EXEC_CYCLES = 37*sim::CYCLES_PER_US;
+const uint64_t EXEC_CYCLES_HOME = 1520*sim::CYCLES_PER_US;
+
+HD44780Model::HD44780Model(uint8_t rs_pin, uint8_t enable_pin, uint8_t d4_pin, uint8_t d5_pin, uint8_t d6_pin,
+                           uint8_t d7_pin) : rs(rs_pin), en(enable_pin), d{d4_pin, d5_pin, d6_pin, d7_pin} {
+  memset(ddram, ' ', sizeof(ddram));
+}
+
+void HD44780Model::attach(transaction_fn fn, void *ctx) {
+  listener = fn;
+  listener_ctx = ctx;
+  sim::onPinChange(pinChanged, this);
+}
+
+uint32_t HD44780Model::transactions() const {
+  uint32_t sum = 0;
+  for(uint8_t i=0; i<KINDS; i++) { sum += count[i]; }
+  return sum;
+}
+
+void HD44780Model::pinChanged(void *ctx, uint8_t pin, uint8_t level) {
+  HD44780Model &m = *(HD44780Model *) ctx;
+
+  for(uint8_t i=0; i<4; i++) {
+    if(pin == m.d[i]) {
+      m.levels = (m.levels & ~(1 << i)) | (level << i);
+      return;
+    }
+  }
+  if(pin == m.rs) {
+    m.levels = (m.levels & ~0x10) | (level << 4);
+    return;
+  }
+  if(pin != m.en || level) { return; }
+
+  // falling edge of E
+  uint8_t nibble = m.levels & 0x0F, r = m.levels >> 4;
+  if(!m.four_bit) {
+    m.execute(nibble << 4, r);
+  }
+  else if(!m.have_high) {
+    m.high = nibble;
+    m.have_high = 1;
+  }
+  else {
+    m.have_high = 0;
+    m.execute((m.high << 4) | nibble, r);
+  }
+}
+
+// the kind of a transaction (KINDS -> no instruction)
+uint8_t HD44780Model::kindOf(uint8_t value, uint8_t r) {
+  if(r) { return DATA; }
+  static const uint8_t KIND[8] = {DDRAM_ADDRESS, CGRAM_ADDRESS, FUNCTION_SET, SHIFT, DISPLAY_CONTROL, ENTRY_MODE,
+                                  HOME, CLEAR};
+  for(uint8_t i=0; i<8; i++) {
+    if(value & (0x80 >> i)) { return KIND[i]; }
+  }
+  return KINDS;
+}
+
+void HD44780Model::execute(uint8_t value, uint8_t r) {
+  uint64_t now = sim::now();
+  if(now < busy_until) { ++violations; }
+  uint64_t exec = EXEC_CYCLES;
+  uint8_t kind = kindOf(value, r);
+  if(kind != KINDS) {
+    ++count[kind];
+    if(listener) { listener(listener_ctx, kind); }
+  }
+
+  switch(kind) {
+    case DATA:
+      if(cgram) { break; }
+      ddram[ac] = value;
+      if(increment) { ac = (ac == 0x27) ? 0x40 : ((ac == 0x67) ? 0x00 : ac + 1); }
+      else { ac = (ac == 0x00) ? 0x67 : ((ac == 0x40) ? 0x27 : ac - 1); }
+    break;
+    case DDRAM_ADDRESS:
+      cgram = 0;
+      ac = value & 0x7F;
+      if((ac > 0x27 && ac < 0x40) || ac > 0x67) { ac = 0; } // invalid address
+    break;
+    case CGRAM_ADDRESS:
+      cgram = 1;
+    break;
+    case FUNCTION_SET:
+      four_bit = !(value & 0x10);
+      have_high = 0;
+    break;
+    case DISPLAY_CONTROL:
+      display_control = value & 0x07;
+    break;
+    case ENTRY_MODE:
+      increment = (value >> 1) & 1;
+    break;
+    case HOME:
+      ac = 0;
+      cgram = 0;
+      exec = EXEC_CYCLES_HOME;
+    break;
+    case CLEAR:
+      memset(ddram, ' ', sizeof(ddram));
+      ac = 0;
+      cgram = 0;
+      increment = 1;
+      exec = EXEC_CYCLES_HOME;
+    break;
+  }
+
+  busy_until = now + exec;
+}
@@ -0,0 +1,59 @@
+/*
+ HD44780Model.h (host builds only, see tests/Readme.txt)
+
+ An HD44780 controller with a 2x16 display as seen at its pins RS, E and D4...D7 (R/W tied to ground): the data
+ lines are latched at the falling edge of E, in 8 bit mode after power-on and in pairs of nibbles after
+ "function set" has selected the 4 bit interface. The DDRAM contents of the visible positions form the
+ framebuffer. Instructions sent before the previous one has been executed (37µs, 1.52ms for "clear display" and
+ "return home") are counted as busy violations; on the display they would have been lost.
+*/
+
+#ifndef HD44780_MODEL_H_
+#define HD44780_MODEL_H_
+
+#include <stdint.h>
+
+class HD44780Model {
+
+public:
+  // the transactions (complete instructions or data writes) by kind
+  enum { CLEAR, HOME, ENTRY_MODE, DISPLAY_CONTROL, SHIFT, FUNCTION_SET, CGRAM_ADDRESS, DDRAM_ADDRESS, DATA, KINDS };
+  // called for each transaction (before it takes effect)
+  typedef void (*transaction_fn)(void *ctx, uint8_t kind);
+
+  HD44780Model(uint8_t rs_pin, uint8_t enable_pin, uint8_t d4_pin, uint8_t d5_pin, uint8_t d6_pin, uint8_t d7_pin);
+  // connects the model to the simulation's pins
+  void attach(transaction_fn fn = 0, void *ctx = 0);
+
+  // the character at a position of the display (row 0/1, column 0...15)
+  uint8_t at(uint8_t row, uint8_t col) const { return ddram[row ? 0x40 + col : col]; }
+  uint8_t address() const { return ac; }
+  uint8_t displayControl() const { return display_control; }
+
+  uint32_t transactions(uint8_t kind) const { return count[kind]; }
+  uint32_t transactions() const;
+  uint32_t busyViolations() const { return violations; }
+
+private:
+  static void pinChanged(void *ctx, uint8_t pin, uint8_t level);
+  static uint8_t kindOf(uint8_t value, uint8_t rs);
+  void execute(uint8_t value, uint8_t rs);
+
+  uint8_t rs, en, d[4];
+  uint8_t levels = 0; // RS (bit 4) and D7...D4 (bits 3...0)
+  uint8_t four_bit = 0;
+  uint8_t have_high = 0;
+  uint8_t high = 0;
+  uint8_t ac = 0;
+  uint8_t cgram = 0;
+  uint8_t increment = 1;
+  uint8_t display_control = 0;
+  uint8_t ddram[0x68];
+  uint64_t busy_until = 0;
+  uint32_t count[KINDS] = {};
+  uint32_t violations = 0;
+  transaction_fn listener = 0;
+  void *listener_ctx = 0;
+};
+
+#endif // HD44780_MODEL_H_
@@ -0,0 +1,692 @@
+/*
+ WSPRduino2_sim.cpp (host builds only, see tests/Readme.txt)
+
+ Runs the sketch on the simulated core with models of the devices at its pins and checks its behaviour:
+  - AD9850 at pins 7, 6, 5, 4: every update of the output is checked against the WSPR protocol (start 1s into an
+    even minute, 162 symbols of 682.7ms, tones matching the encoded message and the WSPR sync vector, band
+    hopping order, duty cycle, no transmission after the loss of GPS data)
+  - SWR-meter at A5/A4: forward and reflected readings while the DDS is on, the SWR of each band scripted over
+    time; a band with an SWR above 3.0 has to be switched off at once and locked after the second trip
+  - GPS-module at pin 2: the datasets of GPS_beacon (every 19s, alternating position/time and astro data),
+    Manchester-coded step by step as DataTransmitterClass::isr does it (with optional skew, jitter and outages)
+  - 1PPS at A0 (optional)
+  - HD44780 at pins 13, 12, 11...8: the display has to show the sketch's "lcd_content" whenever no transfer is
+    pending, without instructions lost due to the display being busy
+
+ The pins and channels are those of WSPR_beacon_user_settings.h. Exit status: 0 if all checks passed, 1 if one
+ failed, 2 if the simulation was aborted.
+*/
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include <random>
+
+#include <Arduino.h>
+#include <avr/eeprom.h>
+#include <SimCore.h>
+#include <AD9850.h>
+#include <WSPR.h>
+#include <GPSDatasets.h>
+#include <ManchesterEncoder.h>
+
+#include "AD9850Model.h"
+#include "HD44780Model.h"
+
+// the sketch's state read by the checks
+extern AD9850 dds;
+extern uint32_t deltaphase;
+extern uint32_t deltaphase_base[];
+extern uint8_t lcd_content[];
+extern uint8_t lcd_refresh_pending;
+uint16_t getSWRValue(uint16_t x);
+uint8_t getSWR(uint16_t ref, uint16_t fwd);
+
+namespace {
+
+//################################################################################################################
+// definitions
+//################################################################################################################
+
+// pins, channels and EEPROM layout of the sketch (see WSPR_beacon_user_settings.h and "setup")
+const uint8_t GPS_PIN = 2;
+const uint8_t PPS_PIN = A0;
+const uint8_t FWD_CHANNEL = 5;
+const uint8_t REF_CHANNEL = 4;
+const uint8_t BAND_COUNT = 10;
+const uint16_t EEPROM_BAND_STATUS = 256;
+const char *const BAND_NAMES[BAND_COUNT] = {"160m", "80m", "60m", "40m", "30m", "20m", "17m", "15m", "12m", "10m"};
+
+// the transmitter (GPS_beacon): byte rate and interval
+const uint8_t GPS_BYTE_RATE = 30;
+const uint32_t GPS_INTERVAL = 19;
+
+// WSPR: symbols, symbol period [cycles] and sync vector
+const uint8_t SYMBOLS = 162;
+const double SYMBOL_CYCLES = 8192.0/12000.0*sim::CYCLES_PER_SECOND;
+const uint8_t SYNC[SYMBOLS] = {
+  1,1,0,0,0,0,0,0,1,0,0,0,1,1,1,0,0,0,1,0,0,1,0,1,1,1,1,0,0,0,0,0,0,0,1,0,0,1,0,1,0,0,0,0,0,0,1,0,1,1,
+  0,0,1,1,0,1,0,0,0,1,1,0,1,0,0,0,0,1,1,0,1,0,1,0,1,0,1,0,0,1,0,0,1,0,1,1,0,0,0,1,1,0,1,0,1,0,0,0,1,0,
+  0,0,0,0,1,0,0,1,0,0,1,1,1,0,1,1,0,0,1,1,0,1,0,0,0,1,1,1,0,0,0,0,0,1,0,1,0,0,1,1,0,0,0,0,0,0,0,1,1,0,
+  1,0,1,1,0,0,0,1,1,0,0,0
+};
+
+// the forward reading of the SWR-meter while the DDS is on
+const uint16_t FWD_LEVEL = 800;
+// the SWR of a band without a scripted value
+const double DEFAULT_SWR = 1.2;
+
+// the maximum permissive age [s] of the last GPS dataset (see "setDisplayContent") and the time it may take the
+// sketch to notice it
+const double GPS_MAX_AGE = 300;
+const double GPS_AGE_SLACK = 30;
+
+// the EEPROM endurance (100000 writes) spread over 10 years
+const double EEPROM_WRITES_PER_DAY = 100000.0/(10*365);
+
+inline double seconds(uint64_t t) { return double(t)/sim::CYCLES_PER_SECOND; }
+inline uint64_t cycles(double s) { return uint64_t(s*sim::CYCLES_PER_SECOND + 0.5); }
+
+//################################################################################################################
+// options
+//################################################################################################################
+
+struct swr_entry {
+  uint8_t band;
+  double swr;
+  uint64_t from;
+};
+
+struct window {
+  uint64_t from;
+  uint64_t to;
+};
+
+struct options {
+  double hours = 2;
+  uint8_t idle = 0;
+  uint16_t bands = 0x3FF;
+  std::vector<swr_entry> swr;
+  std::vector<window> gps_loss;
+  double gps_phase = 0.009;
+  double skew_ppm = 0;
+  double jitter_us = 0;
+  uint8_t pps = 0;
+  double start_tolerance = 0.25;
+  double symbol_tolerance = 0.002;
+  uint32_t seed = 1;
+  uint32_t loop_cost = 400;
+  time_t start_utc = 1767225600; // 2026-01-01 00:00:00
+  uint8_t dds_log = 0;
+  uint8_t lcd_log = 0;
+  uint8_t serial_log = 0;
+  uint8_t quiet = 0;
+} opt;
+
+void usage() {
+  printf("usage: WSPRduino2_sim [options]\n"
+         "  --hours H          virtual time to simulate (default 2)\n"
+         "  --days D           the same in days\n"
+         "  --idle L           duty cycle setting stored in EEPROM (0...19, transmission every 2*(L+1) minutes)\n"
+         "  --bands MASK       bands activated in EEPROM (bit 0 -> 160m ... bit 9 -> 10m, default 0x3FF)\n"
+         "  --swr B=V@H        from hour H on band B (0...9) has the SWR V (repeatable; default SWR %.1f)\n"
+         "  --gps-loss H1-H2   no datasets from the GPS-module between hours H1 and H2 (repeatable)\n"
+         "  --gps-phase S      delay [s] of the datasets after the UTC second they carry (default 0.009)\n"
+         "  --skew PPM         clock error of the GPS-module's transmitter\n"
+         "  --jitter US        max. jitter [us] of each edge sent by the GPS-module\n"
+         "  --pps              drive the 1PPS input (for builds with PPS_INSTALLED)\n"
+         "  --tolerance S      tolerance [s] of the start of a transmission (default 0.25)\n"
+         "  --seed N           seed of the jitter\n"
+         "  --loop-cost C      CPU cycles charged for each run of \"loop\" (default 400)\n"
+         "  --start T          UTC at the beginning (time_t, default 2026-01-01 00:00:00)\n"
+         "  --dds-log --lcd --serial --quiet\n", DEFAULT_SWR);
+  exit(2);
+}
+
+void parseOptions(int argc, char **argv) {
+  for(int i=1; i<argc; i++) {
+    const char *a = argv[i];
+    const char *v = (i + 1 < argc) ? argv[i + 1] : 0;
+    auto value = [&]() { if(!v) { usage(); } ++i; return v; };
+
+    if(!strcmp(a, "--hours")) { opt.hours = atof(value()); }
+    else if(!strcmp(a, "--days")) { opt.hours = 24*atof(value()); }
+    else if(!strcmp(a, "--idle")) { opt.idle = atoi(value()); }
+    else if(!strcmp(a, "--bands")) { opt.bands = strtoul(value(), 0, 0); }
+    else if(!strcmp(a, "--swr")) {
+      unsigned band;
+      double swr, h;
+      if(sscanf(value(), "%u=%lf@%lf", &band, &swr, &h) != 3 || band >= BAND_COUNT) { usage(); }
+      opt.swr.push_back({uint8_t(band), swr, cycles(h*3600)});
+    }
+    else if(!strcmp(a, "--gps-loss")) {
+      double h1, h2;
+      if(sscanf(value(), "%lf-%lf", &h1, &h2) != 2 || h2 < h1) { usage(); }
+      opt.gps_loss.push_back({cycles(h1*3600), cycles(h2*3600)});
+    }
+    else if(!strcmp(a, "--gps-phase")) { opt.gps_phase = atof(value()); }
+    else if(!strcmp(a, "--skew")) { opt.skew_ppm = atof(value()); }
+    else if(!strcmp(a, "--jitter")) { opt.jitter_us = atof(value()); }
+    else if(!strcmp(a, "--pps")) { opt.pps = 1; }
+    else if(!strcmp(a, "--tolerance")) { opt.start_tolerance = atof(value()); }
+    else if(!strcmp(a, "--seed")) { opt.seed = strtoul(value(), 0, 0); }
+    else if(!strcmp(a, "--loop-cost")) { opt.loop_cost = strtoul(value(), 0, 0); }
+    else if(!strcmp(a, "--start")) { opt.start_utc = strtoll(value(), 0, 0); }
+    else if(!strcmp(a, "--dds-log")) { opt.dds_log = 1; }
+    else if(!strcmp(a, "--lcd")) { opt.lcd_log = 1; }
+    else if(!strcmp(a, "--serial")) { opt.serial_log = 1; }
+    else if(!strcmp(a, "--quiet")) { opt.quiet = 1; }
+    else { usage(); } // (also "--help")
+  }
+  if(opt.idle > 19) { usage(); }
+}
+
+uint32_t failures = 0;
+
+void check(bool ok, const char *format, ...) __attribute__((format(printf, 2, 3)));
+void check(bool ok, const char *format, ...) {
+  if(ok) { return; }
+  ++failures;
+  printf("FAILED at %.6fs: ", seconds(sim::now()));
+  va_list args;
+  va_start(args, format);
+  vprintf(format, args);
+  va_end(args);
+  printf("\n");
+}
+
+//################################################################################################################
+// devices
+//################################################################################################################
+
+AD9850Model dds_model(7, 6, 5, 4);
+HD44780Model lcd_model(13, 12, 11, 10, 9, 8);
+std::mt19937 rng;
+
+// the scripted SWR of a band
+double bandSWR(uint8_t band, uint64_t t) {
+  double swr = DEFAULT_SWR;
+  uint64_t from = 0;
+  for(const swr_entry &e : opt.swr) {
+    if(e.band == band && e.from <= t && e.from >= from) {
+      swr = e.swr;
+      from = e.from;
+    }
+  }
+  return swr;
+}
+
+// the band of a tuning word (-1 -> none)
+int bandOf(uint32_t word) {
+  uint32_t width = dds.calculatePhaseValue(200);
+  for(uint8_t i=0; i<BAND_COUNT; i++) {
+    if(word >= deltaphase_base[i] && word - deltaphase_base[i] < width) { return i; }
+  }
+  return -1;
+}
+
+// the reflected reading giving an SWR of at least "swr" with the forward reading FWD_LEVEL (by the sketch's own
+// conversion, which has been verified against the exact formula separately)
+uint16_t refReading(double swr) {
+  static int16_t cache[256];
+  static uint8_t cached[256];
+  uint8_t target = (swr*10 > 255) ? 255 : uint8_t(lround(swr*10));
+  if(!cached[target]) {
+    uint16_t x = 0;
+    while(x < 1023 && getSWR(getSWRValue(x), FWD_LEVEL) < target) { x++; }
+    cache[target] = x;
+    cached[target] = 1;
+  }
+  return cache[target];
+}
+
+// SWR-meter (the readings of the conversion ending now)
+uint64_t last_ref_conversion = 0;
+
+uint16_t adcSource(void *, uint8_t channel) {
+  if(!dds_model.isOn()) { return 0; }
+  if(channel == FWD_CHANNEL) { return FWD_LEVEL; }
+  if(channel == REF_CHANNEL) {
+    int band = bandOf(dds_model.output().word);
+    last_ref_conversion = sim::now();
+    return refReading(band < 0 ? DEFAULT_SWR : bandSWR(band, sim::now()));
+  }
+  return 0;
+}
+
+// GPS-module: a dataset every 19s, sent "gps_phase" after the UTC second it carries
+struct {
+  ManchesterEncoder encoder;
+  uint32_t step_cycles;
+  uint32_t next_second; // the second (since the beginning) the next dataset is sent at
+  uint8_t send_astro;
+  gps_dataset gps;
+  astro_dataset astro;
+  uint32_t sent[2];
+  uint32_t skipped;
+  uint64_t last_gps_end; // the end of the last position/time dataset (0 -> none yet)
+  uint8_t last_was_gps;
+} gps_module;
+
+bool inGPSLoss(uint64_t t) {
+  for(const window &w : opt.gps_loss) {
+    if(t >= w.from && t < w.to) { return true; }
+  }
+  return false;
+}
+
+uint64_t stepDelay() {
+  double d = gps_module.step_cycles*(1 + opt.skew_ppm*1e-6);
+  if(opt.jitter_us > 0) {
+    std::uniform_real_distribution<double> j(-opt.jitter_us, opt.jitter_us);
+    d += j(rng)*sim::CYCLES_PER_US;
+  }
+  return uint64_t(d > 1 ? d : 1);
+}
+
+void gpsStep(void *) {
+  sim::setInput(GPS_PIN, gps_module.encoder.step());
+  if(gps_module.encoder.busy()) { sim::schedule(sim::now() + stepDelay(), gpsStep, 0); }
+  else if(gps_module.last_was_gps) { gps_module.last_gps_end = sim::now(); }
+}
+
+void gpsDataset(void *) {
+  uint32_t s = gps_module.next_second;
+  gps_module.next_second += GPS_INTERVAL;
+  sim::schedule(cycles(gps_module.next_second + opt.gps_phase), gpsDataset, 0);
+
+  if(inGPSLoss(sim::now())) {
+    gps_module.skipped++;
+    return;
+  }
+
+  uint32_t utc = opt.start_utc + s;
+  if(!gps_module.send_astro) {
+    gps_dataset &g = gps_module.gps;
+    g = {51, 4, 13, 'N', 13, 39, 45, 'E', 120, 0, 8, "JO61UB", 20*16, utc};
+    gps_module.encoder.start(GPS_DATASET_ID, (const uint8_t *) &g, sizeof(g));
+  }
+  else {
+    astro_dataset &a = gps_module.astro;
+    a = {0, {utc - 3*3600, utc + 8*3600, utc - 1*3600, utc + 11*3600}, utc, 18000, 2500, 9000, 1000, 5300};
+    gps_module.encoder.start(ASTRO_DATASET_ID, (const uint8_t *) &a, sizeof(a));
+  }
+  gps_module.last_was_gps = !gps_module.send_astro;
+  gps_module.sent[gps_module.send_astro]++;
+  gps_module.send_astro = !gps_module.send_astro;
+  sim::schedule(sim::now() + stepDelay(), gpsStep, 0);
+}
+
+// 1PPS: rising edge at each UTC second, 100ms wide
+void ppsEdge(void *ctx) {
+  uintptr_t level = uintptr_t(ctx);
+  sim::setInput(PPS_PIN, level);
+  uint64_t next = level ? sim::now() + cycles(0.1) : (sim::now()/sim::CYCLES_PER_SECOND + 1)*sim::CYCLES_PER_SECOND;
+  sim::schedule(next, ppsEdge, (void *) (1 - level));
+}
+
+//################################################################################################################
+// checks: transmissions
+//################################################################################################################
+
+struct {
+  uint8_t active;
+  uint8_t band;
+  uint8_t symbols;
+  uint64_t start;
+  uint64_t last_symbol;
+  double max_symbol_error;
+  double max_start_error;
+  uint64_t prev_start; // 0 -> none yet
+  uint8_t prev_band;
+  uint32_t starts[BAND_COUNT];
+  uint32_t complete[BAND_COUNT];
+  uint8_t trips[BAND_COUNT];
+  uint32_t trip_count;
+  double max_trip_latency; // from switching the DDS on
+  double max_stop_latency; // from the end of the conversion
+  uint64_t glitch_until; // a DDS update within this time after a trip is the rest of an interrupted transfer
+  uint32_t glitches;
+  uint32_t updates;
+} tx = {0, 0, 0, 0, 0, 0, 0, 0, BAND_COUNT - 1, {}, {}, {}, 0, 0, 0, 0, 0, 0};
+
+uint8_t psk[4];
+
+// the next band in the hopping order: active in EEPROM and not locked by two trips
+int expectedBand(uint8_t prev) {
+  for(uint8_t i=1; i<=BAND_COUNT; i++) {
+    uint8_t b = (prev + i) % BAND_COUNT;
+    if(((opt.bands >> b) & 1) && tx.trips[b] < 2) { return b; }
+  }
+  return -1;
+}
+
+bool gpsLossBetween(uint64_t from, uint64_t to) {
+  for(const window &w : opt.gps_loss) {
+    if(w.from < to + cycles(GPS_MAX_AGE + GPS_AGE_SLACK) && w.to > from) { return true; }
+  }
+  return false;
+}
+
+void checkSymbol(uint32_t word) {
+  uint8_t i = tx.symbols;
+  check(i < SYMBOLS, "more than %d symbols", SYMBOLS);
+  if(i >= SYMBOLS) { return; }
+  uint8_t symbol = WSPR.getSymbol(i);
+  check(word - deltaphase == psk[symbol & 3], "symbol %d: tone %ld instead of %d", i, long(word - deltaphase),
+        psk[symbol & 3]);
+  check((symbol & 1) == SYNC[i], "symbol %d: sync bit %d instead of %d", i, symbol & 1, SYNC[i]);
+}
+
+void startTransmission(uint64_t t, uint32_t word) {
+  int band = bandOf(word);
+  check(band >= 0, "DDS set to %lu Hz (outside all bands)", dds.calculateFrequency(word));
+  if(band < 0) { return; }
+
+  // 1s into an even minute (plus the delay of the datasets the clock is synchronized to)
+  double utc = double(opt.start_utc % 120) + seconds(t);
+  double error = fmod(utc, 120) - 1 - (opt.pps ? 0 : opt.gps_phase);
+  if(fabs(error) > tx.max_start_error) { tx.max_start_error = fabs(error); }
+  check(fabs(error) <= opt.start_tolerance, "transmission started %.3fs into the even minute", fmod(utc, 120));
+
+  int expected = expectedBand(tx.prev_band);
+  check(band == expected, "transmission on %s instead of %s", BAND_NAMES[band],
+        expected < 0 ? "none" : BAND_NAMES[expected]);
+  check(((opt.bands >> band) & 1), "transmission on %s, which is deactivated", BAND_NAMES[band]);
+
+  // duty cycle: every 2*(idle+1) minutes, later after a loss of GPS data
+  if(tx.prev_start) {
+    double d = seconds(t - tx.prev_start);
+    long periods = lround(d/120);
+    check(fabs(d - 120*periods) <= 2*opt.start_tolerance, "%.3fs between two transmissions", d);
+    if(gpsLossBetween(tx.prev_start, t)) {
+      check(periods >= opt.idle + 1, "%ld minutes between two transmissions (duty cycle %d)", 2*periods, opt.idle);
+    }
+    else {
+      check(periods == opt.idle + 1, "%ld minutes between two transmissions (duty cycle %d)", 2*periods, opt.idle);
+    }
+  }
+
+  // only with valid GPS data
+  check(gps_module.last_gps_end && t - gps_module.last_gps_end <= cycles(GPS_MAX_AGE + GPS_AGE_SLACK),
+        "transmission %.0fs after the last GPS dataset", seconds(t - gps_module.last_gps_end));
+
+  tx.active = 1;
+  tx.band = band;
+  tx.symbols = 0;
+  tx.start = t;
+  tx.last_symbol = t;
+  tx.prev_start = t;
+  tx.prev_band = band;
+  tx.starts[band]++;
+  checkSymbol(word);
+  tx.symbols = 1;
+}
+
+void endTransmission(const AD9850Model::update &u) {
+  tx.active = 0;
+  if(tx.symbols == SYMBOLS && !u.reset) {
+    tx.complete[tx.band]++;
+    check(u.time - tx.last_symbol < cycles(SYMBOL_CYCLES/sim::CYCLES_PER_SECOND + opt.symbol_tolerance),
+          "transmission ended %.3fs after the last symbol", seconds(u.time - tx.last_symbol));
+    return;
+  }
+
+  // stopped early: only by the SWR-meter
+  double swr = bandSWR(tx.band, tx.start);
+  check(swr > 3.0, "transmission on %s (SWR %.1f) stopped after %d symbols", BAND_NAMES[tx.band], swr,
+        tx.symbols);
+  tx.trips[tx.band]++;
+  tx.trip_count++;
+  check(tx.trips[tx.band] <= 2, "%s transmitted after two SWR trips", BAND_NAMES[tx.band]);
+  double latency = seconds(u.time - tx.start);
+  if(latency > tx.max_trip_latency) { tx.max_trip_latency = latency; }
+  double stop = seconds(u.time - last_ref_conversion);
+  if(stop > tx.max_stop_latency) { tx.max_stop_latency = stop; }
+  tx.glitch_until = u.time + cycles(0.001);
+}
+
+void ddsUpdate(void *, const AD9850Model::update &u) {
+  uint8_t on = u.word && !u.power_down;
+  tx.updates++;
+  if(opt.dds_log) {
+    printf("%12.6f DDS %s word %lu (%lu Hz) phase %d%s\n", seconds(u.time), u.reset ? "reset" : "update",
+           (unsigned long) u.word, dds.calculateFrequency(u.word), u.phase, u.power_down ? " power-down" : "");
+  }
+
+  if(!tx.active) {
+    if(!on) { return; }
+    if(u.time < tx.glitch_until) {
+      tx.glitches++;
+      return;
+    }
+    startTransmission(u.time, u.word);
+    return;
+  }
+
+  if(!on) {
+    endTransmission(u);
+    return;
+  }
+
+  check(bandOf(u.word) == tx.band, "frequency changed to %lu Hz during a transmission",
+        dds.calculateFrequency(u.word));
+  double error = seconds(u.time - tx.last_symbol) - SYMBOL_CYCLES/sim::CYCLES_PER_SECOND;
+  if(fabs(error) > tx.max_symbol_error) { tx.max_symbol_error = fabs(error); }
+  check(fabs(error) <= opt.symbol_tolerance, "symbol %d after %.6fs", tx.symbols, seconds(u.time - tx.last_symbol));
+  tx.last_symbol = u.time;
+  checkSymbol(u.word);
+  if(tx.symbols < 255) { tx.symbols++; }
+}
+
+//################################################################################################################
+// checks: display
+//################################################################################################################
+
+const uint64_t LCD_CHECK_CYCLES = sim::CYCLES_PER_SECOND/4;
+uint32_t lcd_checks = 0;
+uint8_t lcd_mismatch = 0;
+char lcd_shown[33];
+
+void lcdCheck(void *) {
+  sim::schedule(sim::now() + LCD_CHECK_CYCLES, lcdCheck, 0);
+  if(lcd_refresh_pending) { return; }
+
+  char screen[33];
+  uint8_t equal = 1;
+  for(uint8_t i=0; i<32; i++) {
+    screen[i] = lcd_model.at(i >> 4, i & 15);
+    if(screen[i] != char(lcd_content[i])) { equal = 0; }
+  }
+  screen[32] = 0;
+  ++lcd_checks;
+
+  // a difference is an error only if it persists (the sketch may be changing "lcd_content" right now)
+  if(!equal) {
+    check(!lcd_mismatch, "display \"%.16s|%.16s\" instead of \"%.16s|%.16s\"", screen, screen + 16,
+          (const char *) lcd_content, (const char *) lcd_content + 16);
+    lcd_mismatch = 1;
+  }
+  else { lcd_mismatch = 0; }
+
+  if(opt.lcd_log && strcmp(screen, lcd_shown)) {
+    printf("%12.6f LCD %.16s|%.16s\n", seconds(sim::now()), screen, screen + 16);
+    memcpy(lcd_shown, screen, sizeof(lcd_shown));
+  }
+}
+
+// the transactions of each refresh of the display (transactions less than 20ms apart) compared with the
+// transactions positioning the cursor for every changed cell would take (address, cursor off, blink off and
+// data per cell, cursor restored at the end); a refresh changing 8 cells or more counts as a screen switch
+const uint64_t REFRESH_GAP_CYCLES = sim::CYCLES_PER_SECOND/50;
+const uint8_t SWITCH_CELLS = 8;
+
+struct refresh_stats {
+  uint32_t count;
+  uint64_t transactions;
+  uint64_t per_cell; // transactions with cursor positioning per cell
+};
+refresh_stats screen_switches = {0, 0, 0}, field_updates = {0, 0, 0};
+char refresh_image[32]; // the display before the current refresh
+uint32_t refresh_transactions = 0;
+uint64_t refresh_last = 0;
+
+void refreshEnd() {
+  uint8_t changed = 0;
+  for(uint8_t i=0; i<32; i++) {
+    char c = lcd_model.at(i >> 4, i & 15);
+    if(c != refresh_image[i]) { ++changed; }
+    refresh_image[i] = c;
+  }
+  if(opt.lcd_log && refresh_transactions) {
+    printf("%12.6f LCD refresh: %u transactions, %u cells changed\n", seconds(refresh_last), refresh_transactions,
+           changed);
+  }
+  if(changed) {
+    refresh_stats &r = (changed >= SWITCH_CELLS) ? screen_switches : field_updates;
+    r.count++;
+    r.transactions += refresh_transactions;
+    r.per_cell += 4*changed + 3;
+  }
+  refresh_transactions = 0;
+}
+
+void lcdTransaction(void *, uint8_t) {
+  if(refresh_transactions && sim::now() - refresh_last > REFRESH_GAP_CYCLES) { refreshEnd(); }
+  refresh_last = sim::now();
+  ++refresh_transactions;
+}
+
+void printRefreshes(const char *name, const refresh_stats &r) {
+  if(!r.count) { return; }
+  printf("  %u %s: %.1f transactions each (%.1f with cursor positioning per cell, %.2fx)\n", r.count, name,
+         double(r.transactions)/r.count, double(r.per_cell)/r.count, double(r.per_cell)/r.transactions);
+}
+
+//################################################################################################################
+// report
+//################################################################################################################
+
+void serialSink(void *, uint8_t c) {
+  if(opt.serial_log) { putchar(c); }
+}
+
+void printISR(const char *name, uint8_t vector) {
+  const sim::isr_stats &s = sim::getISRStats(vector);
+  if(!s.count) { return; }
+  printf("  %-14s %10u calls, avg %5.1f max %5u cycles\n", name, s.count, double(s.cycles)/s.count, s.max);
+}
+
+void report(double wall) {
+  double t = seconds(sim::now());
+  uint32_t starts = 0, complete = 0;
+  for(uint8_t i=0; i<BAND_COUNT; i++) {
+    starts += tx.starts[i];
+    complete += tx.complete[i];
+  }
+
+  printf("\nsimulated %.2fh (%.1fd) in %.1fs (%.0fx)\n", t/3600, t/86400, wall, wall > 0 ? t/wall : 0);
+  printf("transmissions: %u started, %u complete, %u stopped by the SWR-meter, %u DDS updates\n", starts, complete,
+         tx.trip_count, tx.updates);
+  printf("  per band:");
+  for(uint8_t i=0; i<BAND_COUNT; i++) {
+    printf(" %s %u/%u%s", BAND_NAMES[i], tx.complete[i], tx.starts[i], tx.trips[i] >= 2 ? " (locked)" : "");
+  }
+  printf("\n  max. start error %.1fms, max. symbol timing error %.3fms\n", 1000*tx.max_start_error,
+         1000*tx.max_symbol_error);
+  if(tx.trip_count) {
+    printf("  SWR trip: max. %.0fus from switching the DDS on, max. %.0fus from the end of the conversion, "
+           "%u transfer glitches\n", 1e6*tx.max_trip_latency, 1e6*tx.max_stop_latency, tx.glitches);
+  }
+  printf("GPS datasets: %u position/time, %u astro, %u not sent\n", gps_module.sent[0], gps_module.sent[1],
+         gps_module.skipped);
+  printf("display: %u checks, %u transactions (%u data, %u address), %u busy violations\n", lcd_checks,
+         lcd_model.transactions(), lcd_model.transactions(HD44780Model::DATA),
+         lcd_model.transactions(HD44780Model::DDRAM_ADDRESS), lcd_model.busyViolations());
+  refreshEnd();
+  printRefreshes("screen switches", screen_switches);
+  printRefreshes("field updates", field_updates);
+
+  uint32_t max_writes = 0, total_writes = 0;
+  uint16_t max_address = 0;
+  for(uint16_t a=0; a<=E2END; a++) {
+    uint32_t w = sim::eepromWrites(a);
+    total_writes += w;
+    if(w > max_writes) {
+      max_writes = w;
+      max_address = a;
+    }
+  }
+  double days = t/86400;
+  printf("EEPROM: %u writes, max. %u at address %u (%.1f per day)\n", total_writes, max_writes, max_address,
+         days > 0 ? max_writes/days : 0);
+  printf("sleep: %.1f%% (power-save %.1f%%), %u wake-ups\n", 100*seconds(sim::sleepCycles())/t,
+         100*seconds(sim::powerSaveCycles())/t, sim::wakeUps());
+  printf("interrupts:\n");
+  printISR("INT0 (GPS)", 1);
+  printISR("PCINT1 (PPS)", 4);
+  printISR("TIMER2_COMPA", 7);
+  printISR("TIMER2_COMPB", 8);
+  printISR("TIMER2_OVF", 9);
+  printISR("TIMER1_CAPT", 10);
+  printISR("TIMER1_COMPA", 11);
+  printISR("TIMER0_OVF", 16);
+  printISR("ADC", 21);
+
+  // final checks
+  check(lcd_model.busyViolations() == 0, "%u instructions sent to the busy display", lcd_model.busyViolations());
+  check(days < 1 || max_writes/days <= EEPROM_WRITES_PER_DAY, "%.1f EEPROM writes per day at address %u",
+        max_writes/days, max_address);
+  check(starts > 0 || t < 300, "no transmission");
+}
+
+} // namespace
+
+//################################################################################################################
+
+int main(int argc, char **argv) {
+  parseOptions(argc, argv);
+  rng.seed(opt.seed);
+  if(opt.quiet) { opt.dds_log = opt.lcd_log = opt.serial_log = 0; }
+
+  // EEPROM: band status and duty cycle
+  for(uint8_t i=0; i<BAND_COUNT; i++) { sim::eepromPreset(EEPROM_BAND_STATUS + i, (opt.bands >> i) & 1); }
+  sim::eepromPreset(EEPROM_BAND_STATUS + BAND_COUNT, opt.idle);
+
+  // the tones as set up by the sketch
+  const uint32_t PSK_FREQUENCY[4] = {0, 14648, 29296, 43944};
+  for(uint8_t i=1; i<4; i++) { psk[i] = uint8_t(dds.calculatePhaseValue(PSK_FREQUENCY[i])/10000); }
+
+  // devices (the interrupt routines of the sketch are charged with estimates of their own code)
+  dds_model.attach(ddsUpdate, 0);
+  memset(refresh_image, ' ', sizeof(refresh_image));
+  lcd_model.attach(lcdTransaction, 0);
+  sim::setADCSource(adcSource, 0);
+  sim::setSerialSink(serialSink, 0);
+  sim::setISRCost(1, 150);
+  sim::setISRCost(4, 40);
+  sim::setISRCost(7, 10);
+  sim::setISRCost(8, 20);
+  sim::setISRCost(9, 40);
+  sim::setISRCost(10, 150);
+  sim::setISRCost(11, 15);
+  sim::setISRCost(21, 120);
+
+  gps_module.step_cycles = ManchesterEncoder::stepCycles(GPS_BYTE_RATE);
+  gps_module.next_second = 3;
+  sim::schedule(cycles(gps_module.next_second + opt.gps_phase), gpsDataset, 0);
+  if(opt.pps) { sim::schedule(sim::CYCLES_PER_SECOND, ppsEdge, (void *) 1); }
+  sim::schedule(LCD_CHECK_CYCLES, lcdCheck, 0);
+
+  sim::setStopTime(cycles(opt.hours*3600));
+  clock_t start = clock();
+  sim::run(opt.loop_cost);
+  report(double(clock() - start)/CLOCKS_PER_SEC);
+
+  printf("%s\n", failures ? "FAILED" : "PASSED");
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""
+ino2cpp.py (host builds only, see tests/Readme.txt)
+
+Converts a sketch into a C++ translation unit the way the Arduino IDE does: "#include <Arduino.h>" is added and
+prototypes of all functions are inserted in front of the first function definition ("#line" directives keep the
+compiler messages pointing into the sketch). The user settings header is copied into the output directory, with
+settings replaced by "--set NAME=VALUE" (either "const <type> NAME = ...;" or "#define NAME ...").
+
+usage: ino2cpp.py SKETCH.ino OUTPUT.cpp [--settings HEADER] [--set NAME=VALUE ...]
+"""
+
+import argparse
+import os
+import re
+import sys
+
+# a function definition starting in column 0 (e.g. "uint8_t getSWR(uint16_t ref, uint16_t fwd) {")
+DEFINITION = re.compile(r'^((?:inline\s+|static\s+)*[A-Za-z_][\w<>:]*(?:\s*\*+\s*|\s+))(\w+)\s*\(([^;{}()]*)\)\s*\{')
+KEYWORDS = {'if', 'for', 'while', 'switch', 'return', 'else', 'do', 'ISR'}
+
+
+def prototypes(lines):
+    """returns the index of the first function definition and the prototypes of all functions"""
+    first = None
+    result = []
+    for i, line in enumerate(lines):
+        m = DEFINITION.match(line)
+        if not m or m.group(2) in KEYWORDS or line.startswith('ISR'):
+            continue
+        if first is None:
+            first = i
+        result.append('%s%s(%s);' % (m.group(1), m.group(2), m.group(3).strip()))
+    return first, result
+
+
+def apply_settings(text, settings):
+    for name, value in settings:
+        const = re.compile(r'^(const\s+[\w\s]+?\b%s(?:\[[^\]]*\])?\s*(?:PROGMEM\s*)?=\s*)([^;]*)(;)' % re.escape(name), re.M)
+        define = re.compile(r'^(#define\s+%s\s+)(\S+)' % re.escape(name), re.M)
+        text, n = const.subn(lambda m: m.group(1) + value + m.group(3), text)
+        if not n:
+            text, n = define.subn(lambda m: m.group(1) + value, text)
+        if not n:
+            sys.exit('ino2cpp: setting "%s" not found' % name)
+    return text
+
+
+def main():
+    parser = argparse.ArgumentParser(description='converts a sketch into a C++ translation unit')
+    parser.add_argument('sketch')
+    parser.add_argument('output')
+    parser.add_argument('--settings', help='the user settings header included by the sketch')
+    parser.add_argument('--set', action='append', default=[], metavar='NAME=VALUE')
+    args = parser.parse_args()
+
+    with open(args.sketch, encoding='utf-8', newline='') as f:
+        lines = f.read().splitlines()
+    first, protos = prototypes(lines)
+    if first is None:
+        sys.exit('ino2cpp: no function found in "%s"' % args.sketch)
+
+    sketch = os.path.abspath(args.sketch).replace('\\', '/')
+    out = ['#include <Arduino.h>', '#line 1 "%s"' % sketch]
+    out += lines[:first]
+    out += protos
+    out.append('#line %d "%s"' % (first + 1, sketch))
+    out += lines[first:]
+    with open(args.output, 'w', encoding='utf-8') as f:
+        f.write('\n'.join(out) + '\n')
+
+    settings = []
+    for s in args.set:
+        name, _, value = s.partition('=')
+        settings.append((name, value))
+    if args.settings:
+        with open(args.settings, encoding='utf-8', newline='') as f:
+            text = f.read()
+        target = os.path.join(os.path.dirname(os.path.abspath(args.output)), os.path.basename(args.settings))
+        with open(target, 'w', encoding='utf-8', newline='') as f:
+            f.write(apply_settings(text, settings))
+    elif settings:
+        sys.exit('ino2cpp: --set requires --settings')
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,126 @@
+/*
+ CRC8_test.cpp (host builds only, see tests/Readme.txt)
+
+ Checks library "CRC8" in the variant it is compiled with (the Makefile builds it with the lookup table and, as
+ "CRC8_bitwise_test", with CRC8_USE_TABLE=0 for the library and the test):
+  - CRC8Class::update() against the bit loop of the OneWire library (as used by DS18B20) for every CRC register
+    value and data byte (65536 cases)
+  - CRC.crcCalculation() against known CRCs: the check value of "123456789" (0xA1) and the ROM code example of
+    Maxim's application note 27 (family code 0x02, serial number 0x000001B81C -> 0xA2); these pin down the CRC
+    CRCGenerator, which the library replaced, is assumed to compute (its source is not part of this tree, so old
+    transmitters and receivers could not be checked against it)
+
+ With "--bench" the time per byte of a 36 byte dataset is measured instead: the variant compiled, the bit loop and
+ a lookup table read through a function call (standing in for the EEPROM table of CRCGenerator). Exit status: 0
+ if all checks passed, 1 otherwise.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <CRC8.h>
+
+namespace {
+
+uint32_t failures = 0;
+
+void fail(const char *what, long value, long expected, long actual) {
+  if(++failures <= 10) {
+    printf("mismatch: %s for %ld (expected 0x%02lX, got 0x%02lX)\n", what, value, expected, actual);
+  }
+}
+
+// the bit loop of the OneWire library (the non-AVR branch of DS18B20Class::readScratchpad)
+uint8_t bitLoop(uint8_t crc, uint8_t data) {
+  for(uint8_t i=8; i>0; --i) {
+    uint8_t lsb = (crc ^ data) & 0x01;
+    crc >>= 1;
+    data >>= 1;
+    if(lsb) { crc ^= 0x8C; }
+  }
+  return crc;
+}
+
+void checkUpdate() {
+  for(uint16_t crc=0; crc<=0xFF; crc++) {
+    for(uint16_t data=0; data<=0xFF; data++) {
+      uint8_t expected = bitLoop(crc, data), actual = CRC8Class::update(crc, data);
+      if(actual != expected) { fail("update (crc*256 + data)", crc*256 + data, expected, actual); }
+    }
+  }
+}
+
+void checkVectors() {
+  const uint8_t CHECK[8] = {'2', '3', '4', '5', '6', '7', '8', '9'};
+  uint8_t crc = CRC.crcCalculation('1', CHECK, sizeof(CHECK));
+  if(crc != 0xA1) { fail("crcCalculation of \"123456789\"", 0, 0xA1, crc); }
+
+  const uint8_t ROM[6] = {0x1C, 0xB8, 0x01, 0x00, 0x00, 0x00};
+  crc = CRC.crcCalculation(0x02, ROM, sizeof(ROM));
+  if(crc != 0xA2) { fail("crcCalculation of the ROM code", 0, 0xA2, crc); }
+}
+
+// a lookup table behind a function call (as CRCGenerator's table behind EEPROM.read())
+uint8_t lookup_table[256];
+
+__attribute__((noinline)) uint8_t readTable(uint8_t index) {
+  return lookup_table[index];
+}
+
+double seconds() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+// the time [ns] per byte for the CRC of a 36 byte dataset
+template<class F> double measure(F f) {
+  const uint32_t ROUNDS = 1000000;
+  uint8_t data[36];
+  for(uint8_t i=0; i<sizeof(data); i++) { data[i] = 37*i + 11; }
+  volatile uint8_t sink = 0;
+  double start = seconds();
+  for(uint32_t r=0; r<ROUNDS; r++) {
+    data[0] = r;
+    sink = sink + f(uint8_t(r >> 8), data, sizeof(data));
+  }
+  return 1e9*(seconds() - start)/(ROUNDS*37.0);
+}
+
+void bench() {
+  for(uint16_t i=0; i<=0xFF; i++) { lookup_table[i] = crc8Bitwise(i); }
+
+  double library = measure([](uint8_t id, const uint8_t *data, uint8_t size) {
+    return CRC.crcCalculation(id, data, size);
+  });
+  double bits = measure([](uint8_t id, const uint8_t *data, uint8_t size) {
+    uint8_t crc = bitLoop(0, id);
+    for(uint8_t i=0; i<size; ++i) { crc = bitLoop(crc, data[i]); }
+    return crc;
+  });
+  double call = measure([](uint8_t id, const uint8_t *data, uint8_t size) {
+    uint8_t crc = readTable(id);
+    for(uint8_t i=0; i<size; ++i) { crc = readTable(crc ^ data[i]); }
+    return crc;
+  });
+  printf("%-22s %.1fns per byte\n", CRC8_USE_TABLE ? "CRC8 (lookup table):" : "CRC8 (bitwise):", library);
+  printf("%-22s %.1fns per byte\n", "bit loop:", bits);
+  printf("%-22s %.1fns per byte\n", "table behind a call:", call);
+  printf("(host times; on the AVR the EEPROM read and the bit loop cost far more than a table read from flash)\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  if(argc > 1 && !strcmp(argv[1], "--bench")) {
+    bench();
+    return 0;
+  }
+
+  checkUpdate();
+  checkVectors();
+  printf("CRC8 (%s): %s (%u mismatches)\n", CRC8_USE_TABLE ? "lookup table" : "bitwise",
+         failures ? "FAILED" : "PASSED", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,32 @@
+/*
+ NumberFormat_int16.cpp (host builds only, see tests/Readme.txt)
+
+ Library "NumberFormat" compiled with the integer arithmetic of the target (16 bit int, see common/Int16.h) for
+ NumberFormat_test.cpp: "formatInt16" is NF.format() as the AVR computes it, so an intermediate result
+ exceeding 16 bit fails the test although the host's 32 bit int would hide it.
+*/
+
+#include <Arduino.h>
+#include <Int16.h>
+
+// (the headers are included above with the host's types; from here on the library's integer types are
+// avr16::Int, renamed so that they do not clash with the library linked as is)
+#undef pgm_read_byte_near
+#define pgm_read_byte_near(address) (*(const unsigned char *) (address))
+#define uint8_t avr16::Int<unsigned char>
+#define int8_t avr16::Int<signed char>
+#define uint16_t avr16::Int<unsigned short>
+#define int16_t avr16::Int<short>
+#define NumberFormatClass NumberFormatInt16
+#define NF NF_int16
+
+#include "../../libs/NumberFormat/NumberFormat.cpp"
+
+#undef uint8_t
+#undef int8_t
+#undef uint16_t
+#undef int16_t
+
+uint8_t formatInt16(int16_t number, char *text, uint8_t leading_zeros, uint8_t max_digits) {
+  return NF_int16.format(number, text, leading_zeros, max_digits);
+}
@@ -0,0 +1,149 @@
+/*
+ NumberFormat_test.cpp (host builds only, see tests/Readme.txt)
+
+ Checks library "NumberFormat" against the formatting it replaced:
+  - NF.format() against the former "writeNumber" loop of the sketch for every int16 value, 0...3 leading zeros
+    and 1...4 max. digits (1048576 cases; the start index and all characters written have to be equal), both
+    as compiled for the host and with the target's 16 bit integer arithmetic (NumberFormat_int16.cpp), which
+    catches intermediate results overflowing on the AVR only
+  - NF.div10() and NF.div100() for every uint16 value
+  - NF.formatTenths() against "x.y" built with "/" and "%" for 0...255
+
+ With "--bench" the time per call of both formatting functions is measured instead. Exit status: 0 if all checks
+ passed, 1 otherwise.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <NumberFormat.h>
+
+// NF.format() with the integer arithmetic of the target (NumberFormat_int16.cpp)
+uint8_t formatInt16(int16_t number, char *text, uint8_t leading_zeros, uint8_t max_digits);
+
+namespace {
+
+uint32_t failures = 0;
+
+void fail(const char *what, long value, uint8_t leading_zeros, uint8_t max_digits) {
+  if(++failures <= 10) {
+    printf("mismatch: %s for %ld (leading zeros %u, max. digits %u)\n", what, value, leading_zeros, max_digits);
+  }
+}
+
+// the former "writeNumber" of the sketch (baseline), formatting into text[0...4] and returning the start index;
+// the integer arithmetic is that of avr-gcc (16 bit int): "number/i" and "number %= i" are unsigned operations,
+// abs(-32768) is -32768
+uint8_t formerFormat(int16_t number, char *text, uint8_t leading_zeros, uint8_t max_digits) {
+  memcpy(text, " 0000", 5);
+  if(number < 0) {
+    number = int16_t(0 - uint16_t(number));
+    text[0] = '-';
+  }
+
+  uint16_t dummy;
+  uint8_t e = 1;
+  int8_t sp = 1;
+  uint8_t ns = 1;
+  for(uint16_t i=1000; i>1; i/=10) {
+    dummy = uint16_t(number)/i;
+    if(dummy) {
+      text[e] += dummy;
+      ns = 0;
+    }
+    else {
+      if(ns) { sp++; }
+    }
+    number = int16_t(uint16_t(number) % i);
+    e++;
+  }
+  text[4] += number;
+
+  sp -= leading_zeros;
+  if(sp < 1) { sp = 1; }
+
+  uint8_t ssize = 5-max_digits;
+  if(ssize > sp) { sp = ssize; }
+
+  if(text[0]=='-') {
+    sp--;
+    text[sp] = '-';
+  }
+  return sp;
+}
+
+void checkFormat() {
+  for(int32_t v=-32768; v<=32767; v++) {
+    for(uint8_t lz=0; lz<=3; lz++) {
+      for(uint8_t md=1; md<=4; md++) {
+        char expected[5], actual[5];
+        uint8_t e = formerFormat(v, expected, lz, md);
+        uint8_t a = NF.format(v, actual, lz, md);
+        if(a != e || memcmp(actual + a, expected + e, 5 - e)) { fail("format", v, lz, md); }
+        a = formatInt16(v, actual, lz, md);
+        if(a != e || memcmp(actual + a, expected + e, 5 - e)) { fail("format (16 bit int)", v, lz, md); }
+      }
+    }
+  }
+}
+
+void checkDivisions() {
+  for(uint32_t n=0; n<=0xFFFF; n++) {
+    if(NF.div10(n) != n/10) { fail("div10", n, 0, 0); }
+    if(NF.div100(n) != n/100) { fail("div100", n, 0, 0); }
+  }
+}
+
+void checkTenths() {
+  for(uint16_t t=0; t<=255; t++) {
+    uint8_t v = (t > 99) ? 99 : t;
+    char expected[3] = {char('0' + v/10), '.', char('0' + v%10)}, actual[3];
+    NF.formatTenths(t, actual);
+    if(memcmp(actual, expected, 3)) { fail("formatTenths", t, 0, 0); }
+  }
+}
+
+double seconds() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+// the time [ns] per call for all int16 values with the sketch's most common field (2 digits, leading zero)
+template<class F> double measure(F f) {
+  const uint8_t ROUNDS = 20;
+  char text[5];
+  volatile uint8_t sink = 0;
+  double start = seconds();
+  for(uint8_t r=0; r<ROUNDS; r++) {
+    for(int32_t v=-32768; v<=32767; v++) {
+      uint8_t sp = f(v, text, 1, 2);
+      sink = sink + sp + text[4];
+    }
+  }
+  return 1e9*(seconds() - start)/(ROUNDS*65536.0);
+}
+
+void bench() {
+  double former = measure(formerFormat);
+  double nf = measure([](int16_t v, char *t, uint8_t lz, uint8_t md) { return NF.format(v, t, lz, md); });
+  printf("writeNumber loop: %.1fns per call\n", former);
+  printf("NF.format:        %.1fns per call (%.1fx)\n", nf, former/nf);
+  printf("(host times; the divisions cost far more on the AVR, which has no hardware divider)\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  if(argc > 1 && !strcmp(argv[1], "--bench")) {
+    bench();
+    return 0;
+  }
+
+  checkFormat();
+  checkDivisions();
+  checkTenths();
+  printf("NumberFormat: %s (%u mismatches)\n", failures ? "FAILED" : "PASSED", failures);
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,143 @@
+/*
+ SWR_test.cpp (host builds only, see tests/Readme.txt)
+
+ Checks the SWR-meter's calculations of the sketch (linked from the "default" variant) against the code they
+ replaced:
+  - initSWRTable()/getSWRValue() against the former "getPolyValue" of the sketch for every ADC reading (0...1023)
+    with the supporting points SWR_X/SWR_Y of WSPR_beacon_user_settings.h; getSWRValue() may be at most 1 LSB
+    above the former value (the slopes are rounded up), never below
+  - getSWR() against the former division formula for every linearised value (0...65535) and forward reading
+    (1...1023); the results have to be equal
+
+ With "--bench" the time per call of the former and the current version is measured instead. Exit status: 0 if all
+ checks passed, 1 otherwise.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <Arduino.h>
+#include <HD44780.h>
+
+// the sketch's settings (the namespace keeps its global variables apart from the sketch's own copies)
+namespace settings {
+#include "WSPR_beacon_user_settings.h"
+}
+using settings::SWR_X;
+using settings::SWR_Y;
+
+// functions of the sketch
+void initSWRTable();
+uint16_t getSWRValue(uint16_t x);
+uint8_t getSWR(uint16_t ref, uint16_t fwd);
+
+namespace {
+
+const uint16_t POINTS = sizeof(SWR_X)/sizeof(SWR_X[0]);
+
+uint32_t failures = 0;
+
+void fail(const char *what, long value, long expected, long actual) {
+  if(++failures <= 10) {
+    printf("mismatch: %s for %ld (expected %ld, got %ld)\n", what, value, expected, actual);
+  }
+}
+
+// the former "getPolyValue" of the sketch (baseline); on the target "(yend-ybegin)*(x-xbegin)" is a 16 bit
+// product, which overflows for the wider segments of SWR_X/SWR_Y (e.g. 1829*47 from x = 140 on), so the
+// reference is the interpolation that was meant: the same expression in 32 bit
+uint16_t formerPolyValue(const int16_t x, const uint16_t size, const uint16_t* array_x, const uint16_t* array_y) {
+  uint16_t y = 0;
+  uint16_t xbegin, xend, ybegin, yend;
+
+  for(uint16_t i=0; i<size-1; i++) {
+    xbegin = pgm_read_word_near(array_x + i);
+    xend = pgm_read_word_near(array_x + i + 1);
+
+    if((xbegin<=xend && x>=xbegin && x<=xend) || (xbegin>xend && x<=xbegin && x>=xend)) {
+      ybegin = pgm_read_word_near(array_y + i);
+      yend = pgm_read_word_near(array_y + i + 1);
+
+      y = ybegin + int32_t(uint32_t(yend-ybegin)*uint32_t(x-xbegin))/(xend-xbegin);
+      break;
+    }
+  }
+
+  return y;
+}
+
+void checkSWRValue() {
+  initSWRTable();
+  uint16_t above = 0;
+  for(uint16_t x=0; x<=1023; x++) {
+    uint16_t expected = formerPolyValue(x, POINTS, SWR_X, SWR_Y);
+    uint16_t actual = getSWRValue(x);
+    if(actual < expected || actual > expected + 1) { fail("getSWRValue", x, expected, actual); }
+    above += (actual != expected);
+  }
+  printf("getSWRValue: %u of 1024 ADC readings 1 LSB above the former value\n", above);
+}
+
+// the former SWR calculation of the sketch (baseline, 32 bit unsigned arithmetic as on the target)
+uint8_t formerSWR(uint16_t ref, uint16_t fwd) {
+  uint32_t ref_value = ref;
+  ref_value <<= 16;
+  ref_value /= fwd;
+  if(ref_value > 1712353) { ref_value = 1712353; }
+  return (20971520 + 10*ref_value)/(2097152 - ref_value);
+}
+
+void checkSWR() {
+  for(uint32_t ref=0; ref<=0xFFFF; ref++) {
+    for(uint16_t fwd=1; fwd<=1023; fwd++) {
+      uint8_t expected = formerSWR(ref, fwd), actual = getSWR(ref, fwd);
+      if(actual != expected) { fail("getSWR (ref*1024 + fwd)", ref*1024 + fwd, expected, actual); }
+    }
+  }
+}
+
+double seconds() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+// the time [ns] per call for all ADC readings (for getSWR: all linearised values as reflected and 1023 as forward
+// reading, i.e. SWR 1.0...3.1)
+template<class F> double measure(F f) {
+  const uint16_t ROUNDS = 2000;
+  volatile uint16_t sink = 0;
+  double start = seconds();
+  for(uint16_t r=0; r<ROUNDS; r++) {
+    for(uint16_t x=0; x<=1023; x++) { sink = sink + f(x); }
+  }
+  return 1e9*(seconds() - start)/(ROUNDS*1024.0);
+}
+
+void bench() {
+  initSWRTable();
+  double former = measure([](uint16_t x) { return formerPolyValue(x, POINTS, SWR_X, SWR_Y); });
+  double table = measure(getSWRValue);
+  printf("getPolyValue: %.1fns per call\n", former);
+  printf("getSWRValue:  %.1fns per call (%.1fx)\n", table, former/table);
+  double former_swr = measure([](uint16_t x) { return uint16_t(formerSWR(getSWRValue(x), 1023)); });
+  double search = measure([](uint16_t x) { return uint16_t(getSWR(getSWRValue(x), 1023)); });
+  printf("getSWRValue + division formula: %.1fns per call\n", former_swr);
+  printf("getSWRValue + getSWR:           %.1fns per call (%.1fx)\n", search, former_swr/search);
+  printf("(host times; the divisions cost far more on the AVR, which has no hardware divider)\n");
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  if(argc > 1 && !strcmp(argv[1], "--bench")) {
+    bench();
+    return 0;
+  }
+
+  checkSWRValue();
+  checkSWR();
+  printf("SWR: %s (%u mismatches)\n", failures ? "FAILED" : "PASSED", failures);
+  return failures ? 1 : 0;
+}